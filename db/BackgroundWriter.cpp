@@ -0,0 +1,53 @@
+#include <db/BackgroundWriter.h>
+#include <db/BufferPool.h>
+
+using namespace db;
+
+BackgroundWriter::BackgroundWriter(BufferPool &pool, std::chrono::milliseconds interval)
+        : pool(pool), interval(interval) {
+}
+
+BackgroundWriter::~BackgroundWriter() {
+    {
+        std::lock_guard<std::mutex> guard(latch);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void BackgroundWriter::start() {
+    std::lock_guard<std::mutex> guard(latch);
+    if (!thread.joinable() && !stopping) {
+        thread = std::thread(&BackgroundWriter::run, this);
+    }
+}
+
+void BackgroundWriter::wake() {
+    {
+        std::lock_guard<std::mutex> guard(latch);
+        requested = true;
+    }
+    wakeup.notify_all();
+}
+
+void BackgroundWriter::run() {
+    std::unique_lock<std::mutex> guard(latch);
+    while (!stopping) {
+        wakeup.wait_for(guard, interval, [this] { return stopping || requested; });
+        if (stopping) {
+            return;
+        }
+        requested = false;
+
+        guard.unlock();
+        try {
+            pool.flushDirtyPages(false);
+        } catch (const std::exception &) {
+            // Leave the pages dirty; the next round or a checkpoint retries
+        }
+        guard.lock();
+    }
+}
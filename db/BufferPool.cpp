@@ -1,39 +1,573 @@
 #include <db/BufferPool.h>
 #include <db/Database.h>
+#include <db/HeapFile.h>
+#include <db/ScanRing.h>
+#include <algorithm>
+#include <thread>
 
 using namespace db;
 
-BufferPool::BufferPool(int numPages): capacity(numPages) {
-    pageCache.reserve(numPages); // reserve(n) creates enough buckets in the unordered_map (pageCache) to hold at least n items.
+//
+// PageGuard
+//
+
+PageGuard::PageGuard(PageGuard &&other) noexcept
+        : pool(other.pool), ring(other.ring), shard(other.shard), frame(other.frame), page(other.page) {
+    other.pool = nullptr;
+    other.ring = nullptr;
+    other.page = nullptr;
+}
+
+PageGuard &PageGuard::operator=(PageGuard &&other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        ring = other.ring;
+        shard = other.shard;
+        frame = other.frame;
+        page = other.page;
+        other.pool = nullptr;
+        other.ring = nullptr;
+        other.page = nullptr;
+    }
+    return *this;
+}
+
+void PageGuard::markDirty(const TransactionId &tid) {
+    if (ring != nullptr) {
+        throw std::logic_error("PageGuard: pages read through a scan ring are read-only.");
+    }
+    pool->markDirty(shard, frame, tid);
+}
+
+void PageGuard::release() {
+    if (pool != nullptr) {
+        pool->unpin(shard, frame);
+    } else if (ring != nullptr) {
+        ring->unpin(frame);
+    }
+    pool = nullptr;
+    ring = nullptr;
+    page = nullptr;
+}
+
+//
+// BufferPool
+//
+
+BufferPool::Shard::Shard(int numFrames, ReplacementPolicyType policyType)
+        : frames(numFrames), policy(ReplacementPolicy::create(policyType, numFrames)) {
+    pageTable.reserve(numFrames); // reserve(n) creates enough buckets in the unordered_map (pageTable) to hold at least n items.
+    freeFrames.reserve(numFrames);
+    for (int i = numFrames - 1; i >= 0; i--) {
+        freeFrames.push_back(i);
+    }
+}
+
+BufferPool::BufferPool(int numPages, ReplacementPolicyType policyType, int numShards, bool useHugePages)
+        : capacity(numPages), useHugePages(useHugePages), readAhead(std::make_unique<ReadAhead>(*this, PREFETCH_THREADS, DEFAULT_PREFETCH_DEPTH)),
+          writer(std::make_unique<BackgroundWriter>(*this, std::chrono::milliseconds(BackgroundWriter::DEFAULT_INTERVAL_MS))) {
+    if (numShards <= 0) {
+        int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        numShards = std::min(cores * 2, numPages / MIN_FRAMES_PER_SHARD);
+    }
+    numShards = std::max(1, std::min(numShards, std::max(numPages, 1)));
+
+    // Spread the frames as evenly as possible over the shards
+    for (int i = 0; i < numShards; i++) {
+        int frames = numPages / numShards + (i < numPages % numShards ? 1 : 0);
+        shards.push_back(std::make_unique<Shard>(frames, policyType));
+    }
+    allocateFrames();
+}
+
+void BufferPool::allocateFrames() {
+    arena = std::make_unique<FrameArena>(capacity, pageSize, useHugePages);
+    size_t next = 0;
+    for (auto &shard : shards) {
+        for (Frame &f : shard->frames) {
+            f.data = arena->frame(next++);
+        }
+    }
+}
+
+void BufferPool::setPageSize(int newPageSize) {
+    if (newPageSize == pageSize) {
+        return;
+    }
+    // Frames are sized by the page size: drop every cached page, then reallocate
+    flushAllPages();
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        while (!shard->pageTable.empty()) {
+            if (!evictPage(*shard)) {
+                throw std::logic_error("BufferPool: cannot change the page size while pages are pinned.");
+            }
+        }
+    }
+    pageSize = newPageSize;
+    allocateFrames();
+}
+
+BufferPool::~BufferPool() {
+    // Stop the I/O and writer threads before the frames go away
+    readAhead.reset();
+    writer.reset();
+    // Then write back what the writer had not got to yet
+    try {
+        flushAllPages();
+    } catch (const std::exception &) {
+        // Nothing can report the error from a destructor; the changes are lost
+    }
+    for (auto &shard : shards) {
+        for (Frame &f : shard->frames) {
+            delete f.page;
+        }
+    }
+}
+
+PageGuard BufferPool::getPage(const TransactionId &tid, PageId *pid) {
+    // Background read-ahead and eviction may free an unpinned frame at any time
+    return fetchPage(tid, *pid);
+}
+
+PageGuard BufferPool::fetchPage(const TransactionId &, const PageId &pid) {
+    size_t shardIndex;
+    int frame;
+    Page *page = fetch(pid, true, false, shardIndex, frame);
+    return {this, shardIndex, frame, page};
+}
+
+PageGuard BufferPool::fetchPage(const TransactionId &tid, const PageId &pid, ScanRing *ring) {
+    if (ring == nullptr) {
+        return fetchPage(tid, pid);
+    }
+    size_t shardIndex;
+    int frame;
+    if (Page *page = fetch(pid, true, true, shardIndex, frame)) {
+        return {this, shardIndex, frame, page};
+    }
+    // Read ahead within the ring: the window is read with one batched readPages
+    int prefetched;
+    Page *page = ring->pin(pid, std::max(1, readAhead->getDepth()), frame, prefetched);
+    ringReads++;
+    prefetches += prefetched;
+    return {ring, frame, page};
 }
 
-Page *BufferPool::getPage(const TransactionId &tid, PageId *pid) {
-    // Check if the page is in cache
-    auto it = pageCache.find(pid);
-    if(it != pageCache.end()) {
-        // Move the page to the back of the LRU queue (recently accessed)
-        auto lruIt = std::find(lruQueue.begin(), lruQueue.end(), pid);
-        lruQueue.erase(lruIt);
-        lruQueue.push_back(pid);
-        return it->second;
+std::unique_ptr<ScanRing> BufferPool::createScanRing(int numPages) const {
+    if (numPages <= capacity / SCAN_RING_FRACTION) {
+        return nullptr;
+    }
+    return std::make_unique<ScanRing>(ScanRing::DEFAULT_SIZE, pageSize);
+}
+
+Page *BufferPool::fetch(const PageId &pid, bool pin, bool cachedOnly, size_t &shardIndex, int &frame) {
+    PageKey key(pid);
+    shardIndex = shardFor(key);
+    Shard &shard = *shards[shardIndex];
+
+    std::unique_lock<std::mutex> guard(shard.latch);
+    auto it = shard.pageTable.find(key);
+    while (true) {
+        if (it != shard.pageTable.end() && shard.frames[it->second].loading) {
+            // Another thread is reading the page into a frame: wait for it and look again
+            shard.loaded.wait(guard);
+        } else if (!cachedOnly && it == shard.pageTable.end() && shard.freeFrames.empty() && !evictPage(shard)) {
+            if (writeBackPage(shard, guard)) {
+                // Every unpinned page was dirty and one is clean now, unless it was
+                // dirtied again while the latch was dropped: look again
+            } else if (shard.numLoading != 0) {
+                // Every frame is pinned, some only while loading (e.g. by read-ahead): wait for them
+                shard.loaded.wait(guard);
+            } else {
+                break;
+            }
+        } else {
+            break;
+        }
+        it = shard.pageTable.find(key);
     }
 
-    // If not in cache, fetch from the disk
-    DbFile* file = Database::getCatalog().getDatabaseFile(pid->getTableId());
-    Page* page = file->readPage(*pid);
+    if (it != shard.pageTable.end()) {
+        // The page is in cache
+        shard.hits++;
+        frame = it->second;
+        Frame &f = shard.frames[frame];
+        bool firstPrefetchedHit = f.prefetched;
+        if (f.prefetched) {
+            // Loading the page already counted as its first access
+            f.prefetched = false;
+        } else {
+            shard.policy->recordAccess(frame);
+        }
+        if (pin && f.pinCount++ == 0) {
+            updateEvictable(shard, frame);
+        }
+        Page *page = f.page;
+        guard.unlock();
+        if (firstPrefetchedHit && !cachedOnly) {
+            // The scan reached the prefetched window: keep reading ahead
+            noteSequentialCandidate(key, Database::getCatalog().getDatabaseFile(key.tableId));
+        }
+        return page;
+    }
+
+    if (cachedOnly) {
+        return nullptr;
+    }
 
-    // If buffer is full, evict a page
-    if(pageCache.size() == capacity) {
-        evictPage();
+    // If not in cache, claim a frame, evicting an unpinned page if the shard is full
+    shard.misses++;
+    frame = reserveFrame(shard, key);
+    if (frame == -1) {
+        throw std::runtime_error("BufferPool: all pages are pinned, no page to evict.");
     }
+    guard.unlock();
 
-    // Insert into cache and LRU queue
-    pageCache[pid] = page;
-    lruQueue.push_back(pid);
+    // Read from the disk straight into the frame without holding the latch
+    Page *page;
+    try {
+        DbFile *file = Database::getCatalog().getDatabaseFile(pid.getTableId());
+        noteSequentialCandidate(key, file);
+        page = file->readPage(pid, shard.frames[frame].data);
+    } catch (...) {
+        guard.lock();
+        abandonLoad(shard, frame);
+        throw;
+    }
 
+    guard.lock();
+    completeLoad(shard, frame, page, pin, false);
     return page;
 }
 
+int BufferPool::reserveFrame(Shard &shard, const PageKey &key) {
+    if (shard.freeFrames.empty() && !evictPage(shard)) {
+        return -1;
+    }
+
+    int frame = shard.freeFrames.back();
+    shard.freeFrames.pop_back();
+    Frame &f = shard.frames[frame];
+    f.key = key;
+    f.page = nullptr;
+    f.loading = true;
+    f.pinCount = 1; // Held by the loading thread
+    f.prefetched = false;
+    f.dirty = false;
+    updateEvictable(shard, frame);
+    shard.pageTable.emplace(key, frame);
+    shard.numLoading++;
+    return frame;
+}
+
+void BufferPool::completeLoad(Shard &shard, int frame, Page *page, bool pin, bool prefetched) {
+    Frame &f = shard.frames[frame];
+    f.page = page;
+    f.loading = false;
+    shard.numLoading--;
+    f.prefetched = prefetched;
+    if (!pin) {
+        f.pinCount--;
+    }
+    shard.policy->recordInsert(frame, f.key);
+    updateEvictable(shard, frame);
+    shard.loaded.notify_all();
+}
+
+void BufferPool::abandonLoad(Shard &shard, int frame) {
+    Frame &f = shard.frames[frame];
+    shard.pageTable.erase(f.key);
+    f.key = PageKey(-1, -1);
+    f.loading = false;
+    shard.numLoading--;
+    f.pinCount = 0;
+    shard.freeFrames.push_back(frame);
+    shard.loaded.notify_all();
+}
+
+void BufferPool::noteSequentialCandidate(const PageKey &key, const DbFile *file) {
+    if (readAhead->getDepth() == 0) {
+        return;
+    }
+    // Read-ahead only knows how far to go for heap files
+    if (const auto *heapFile = dynamic_cast<const HeapFile *>(file)) {
+        readAhead->onAccess(key, heapFile->getNumPages());
+    }
+}
+
+void BufferPool::prefetchPages(int tableId, int firstPage, int count) {
+    const HeapFile *heapFile;
+    try {
+        heapFile = dynamic_cast<const HeapFile *>(Database::getCatalog().getDatabaseFile(tableId));
+    } catch (const std::exception &) {
+        return;
+    }
+    if (heapFile == nullptr) {
+        return;
+    }
+
+    /** A frame reserved for a page being prefetched. */
+    struct Reserved {
+        int pageNo;
+        size_t shard;
+        int frame;
+    };
+
+    // Claim frames for the pages that are not cached yet
+    std::vector<Reserved> reserved;
+    for (int pageNo = firstPage; pageNo < firstPage + count; pageNo++) {
+        PageKey key(tableId, pageNo);
+        size_t shardIndex = shardFor(key);
+        Shard &shard = *shards[shardIndex];
+        std::lock_guard<std::mutex> guard(shard.latch);
+        if (shard.pageTable.count(key) != 0) {
+            continue;
+        }
+        int frame = reserveFrame(shard, key);
+        if (frame == -1) {
+            // Every frame is pinned: leave the rest to the scan
+            break;
+        }
+        reserved.push_back({pageNo, shardIndex, frame});
+    }
+
+    // Read each run of consecutive pages with one batch
+    size_t i = 0;
+    while (i < reserved.size()) {
+        size_t end = i + 1;
+        while (end < reserved.size() && reserved[end].pageNo == reserved[end - 1].pageNo + 1) {
+            end++;
+        }
+        std::vector<uint8_t *> frames;
+        for (size_t j = i; j < end; j++) {
+            frames.push_back(shards[reserved[j].shard]->frames[reserved[j].frame].data);
+        }
+
+        std::vector<Page *> pages;
+        try {
+            pages = heapFile->readPages(reserved[i].pageNo, static_cast<int>(end - i), frames);
+        } catch (const std::exception &) {
+            // Prefetching is only a hint; the foreground read will report the error
+        }
+        for (size_t j = i; j < end; j++) {
+            Shard &shard = *shards[reserved[j].shard];
+            std::lock_guard<std::mutex> guard(shard.latch);
+            if (pages.empty()) {
+                abandonLoad(shard, reserved[j].frame);
+            } else {
+                completeLoad(shard, reserved[j].frame, pages[j - i], false, true);
+                prefetches++;
+            }
+        }
+        i = end;
+    }
+}
+
+void BufferPool::updateEvictable(Shard &shard, int frame) {
+    const Frame &f = shard.frames[frame];
+    shard.policy->setEvictable(frame, f.pinCount == 0 && !f.dirty);
+}
+
+void BufferPool::unpin(size_t shardIndex, int frame) {
+    Shard &shard = *shards[shardIndex];
+    std::lock_guard<std::mutex> guard(shard.latch);
+    if (--shard.frames[frame].pinCount == 0) {
+        updateEvictable(shard, frame);
+    }
+}
+
+void BufferPool::markDirty(size_t shardIndex, int frame, const TransactionId &tid) {
+    Shard &shard = *shards[shardIndex];
+    {
+        std::lock_guard<std::mutex> guard(shard.latch);
+        Frame &f = shard.frames[frame];
+        if (Database::getCatalog().getDatabaseFile(f.key.tableId)->isReadOnly()) {
+            // The writer could never clean the page, and would retry it forever
+            throw std::logic_error("BufferPool: pages of a read-only file cannot be modified.");
+        }
+        f.page->markDirty(true, tid);
+        f.dirtyVersion++;
+        if (!f.dirty) {
+            f.dirty = true;
+            shard.numDirty++;
+            updateEvictable(shard, frame);
+        }
+    }
+    writer->start();
+}
+
+bool BufferPool::evictPage(Shard &shard) {
+    int victim = shard.policy->selectVictim();
+    if (victim == -1) {
+        if (shard.numDirty != 0) {
+            // Unpinned pages may all be dirty: have the writer clean some
+            writer->wake();
+        }
+        return false;
+    }
+
+    Frame &f = shard.frames[victim];
+    shard.pageTable.erase(f.key);
+    delete f.page;
+    f.page = nullptr;
+    f.key = PageKey(-1, -1);
+    shard.freeFrames.push_back(victim);
+    return true;
+}
+
+bool BufferPool::writeBackPage(Shard &shard, std::unique_lock<std::mutex> &guard) {
+    std::vector<DirtyPage> pages;
+    for (int frame = 0; frame < static_cast<int>(shard.frames.size()); frame++) {
+        Frame &f = shard.frames[frame];
+        if (f.page != nullptr && f.pinCount == 0 && f.dirty) {
+            // Pin the frame so it stays put while it is written without the latch
+            f.pinCount++;
+            updateEvictable(shard, frame);
+            pages.push_back({shardFor(f.key), frame, f.key, f.page, f.dirtyVersion});
+            break;
+        }
+    }
+    if (pages.empty()) {
+        return false;
+    }
+    guard.unlock();
+    writeDirtyPages(pages);
+    guard.lock();
+    return true;
+}
+
 void BufferPool::evictPage() {
-    // do nothing for now
+    size_t start = nextEvictShard++;
+    for (size_t i = 0; i < shards.size(); i++) {
+        Shard &shard = *shards[(start + i) % shards.size()];
+        std::unique_lock<std::mutex> guard(shard.latch);
+        if (evictPage(shard) || (writeBackPage(shard, guard) && evictPage(shard))) {
+            return;
+        }
+    }
+    throw std::runtime_error("BufferPool: no page to evict.");
+}
+
+void BufferPool::flushPage(const PageId &pid) {
+    PageKey key(pid);
+    size_t shardIndex = shardFor(key);
+    Shard &shard = *shards[shardIndex];
+    std::vector<DirtyPage> pages;
+    {
+        std::lock_guard<std::mutex> guard(shard.latch);
+        auto it = shard.pageTable.find(key);
+        if (it == shard.pageTable.end() || !shard.frames[it->second].dirty) {
+            return;
+        }
+        Frame &f = shard.frames[it->second];
+        // Pin the frame so it stays put while it is written without the latch
+        f.pinCount++;
+        updateEvictable(shard, it->second);
+        pages.push_back({shardIndex, it->second, key, f.page, f.dirtyVersion});
+    }
+    writeDirtyPages(pages);
+}
+
+void BufferPool::flushAllPages() {
+    flushDirtyPages(true);
+}
+
+void BufferPool::flushDirtyPages(bool includePinned) {
+    std::vector<DirtyPage> pages;
+    for (size_t i = 0; i < shards.size(); i++) {
+        Shard &shard = *shards[i];
+        std::lock_guard<std::mutex> guard(shard.latch);
+        if (shard.numDirty == 0) {
+            continue;
+        }
+        for (int frame = 0; frame < static_cast<int>(shard.frames.size()); frame++) {
+            Frame &f = shard.frames[frame];
+            if (f.page == nullptr || !f.dirty || (!includePinned && f.pinCount != 0)) {
+                continue;
+            }
+            f.pinCount++;
+            updateEvictable(shard, frame);
+            pages.push_back({i, frame, f.key, f.page, f.dirtyVersion});
+        }
+    }
+    writeDirtyPages(pages);
+}
+
+void BufferPool::writeDirtyPages(std::vector<DirtyPage> &pages) {
+    // Group by file and order by page number so adjacent pages merge into one write
+    std::sort(pages.begin(), pages.end(), [](const DirtyPage &a, const DirtyPage &b) {
+        return a.key.tableId != b.key.tableId ? a.key.tableId < b.key.tableId : a.key.pageNo < b.key.pageNo;
+    });
+
+    size_t written = 0;
+    try {
+        while (written < pages.size()) {
+            size_t end = written;
+            std::vector<Page *> batch;
+            while (end < pages.size() && pages[end].key.tableId == pages[written].key.tableId) {
+                batch.push_back(pages[end].page);
+                end++;
+            }
+            Database::getCatalog().getDatabaseFile(pages[written].key.tableId)->writePages(batch);
+            written = end;
+        }
+    } catch (...) {
+        // Leave every page dirty; release the pins and report
+        for (DirtyPage &p : pages) {
+            unpin(p.shard, p.frame);
+        }
+        throw;
+    }
+
+    for (DirtyPage &p : pages) {
+        Shard &shard = *shards[p.shard];
+        std::lock_guard<std::mutex> guard(shard.latch);
+        Frame &f = shard.frames[p.frame];
+        // A markDirty that raced with the write keeps the page dirty
+        if (f.dirty && f.dirtyVersion == p.version) {
+            f.dirty = false;
+            f.page->markDirty(false, TransactionId());
+            shard.numDirty--;
+        }
+        f.pinCount--;
+        updateEvictable(shard, p.frame);
+    }
+}
+
+size_t BufferPool::getNumDirtyPages() const {
+    size_t count = 0;
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        count += shard->numDirty;
+    }
+    return count;
+}
+
+size_t BufferPool::getNumCachedPages() const {
+    size_t count = 0;
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        count += shard->pageTable.size();
+    }
+    return count;
+}
+
+size_t BufferPool::getHitCount() const {
+    size_t count = 0;
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        count += shard->hits;
+    }
+    return count;
+}
+
+size_t BufferPool::getMissCount() const {
+    size_t count = 0;
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        count += shard->misses;
+    }
+    return count;
 }
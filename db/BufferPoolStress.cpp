@@ -0,0 +1,88 @@
+/**
+ * Multi-threaded getPage stress and throughput driver for the sharded
+ * BufferPool. Every thread fetches uniformly random pages of one table through
+ * the shared pool, for 1, 2, 4, ... threads, and the driver reports the
+ * operations per second in total and per thread.
+ *
+ * Usage: bufferpool_stress [file] [table pages] [pool pages] [ops per thread] [max threads]
+ */
+#include <db/Database.h>
+#include <db/HeapFile.h>
+#include <db/HeapPageId.h>
+#include <db/Utility.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace db;
+
+/** Writes a table of numPages empty pages. */
+static void createTable(const char *fname, int numPages) {
+    FILE *file = fopen(fname, "wb");
+    if (file == nullptr) {
+        perror(fname);
+        exit(1);
+    }
+    std::vector<uint8_t> page(Database::getBufferPool().getPageSize(), 0);
+    for (int i = 0; i < numPages; i++) {
+        fwrite(page.data(), 1, page.size(), file);
+    }
+    fclose(file);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fname = argc > 1 ? argv[1] : "bufferpool_stress.dat";
+    int numPages = argc > 2 ? atoi(argv[2]) : 8192;
+    int poolPages = argc > 3 ? atoi(argv[3]) : 4096;
+    long opsPerThread = argc > 4 ? atol(argv[4]) : 200000;
+    int maxThreads = argc > 5 ? atoi(argv[5]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    createTable(fname, numPages);
+    Database::reset();
+    // The Catalog does not own its files; this one outlives the Database::reset below
+    auto file = std::make_unique<HeapFile>(fname, Utility::getTupleDesc(2));
+    Database::getCatalog().addTable(file.get(), "stress");
+    int tableId = file->getId();
+
+    printf("%d pages, %d pool pages, %ld getPage calls per thread\n", numPages, poolPages, opsPerThread);
+    printf("%8s %8s %14s %18s %10s\n", "threads", "shards", "ops/sec", "ops/sec/thread", "hit ratio");
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        Database::resetBufferPool(poolPages);
+        BufferPool &pool = Database::getBufferPool();
+        pool.setPrefetchDepth(0);
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&, t] {
+                TransactionId tid;
+                std::mt19937 random(t + 1);
+                std::uniform_int_distribution<int> pageNo(0, numPages - 1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (long i = 0; i < opsPerThread; i++) {
+                    PageGuard guard = pool.fetchPage(tid, HeapPageId(tableId, pageNo(random)));
+                }
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double opsPerSec = static_cast<double>(opsPerThread) * numThreads / elapsed.count();
+        printf("%8d %8zu %14.0f %18.0f %10.3f\n", numThreads, pool.getNumShards(), opsPerSec,
+               opsPerSec / numThreads, pool.getHitRatio());
+    }
+    Database::reset();
+    remove(fname);
+    return 0;
+}
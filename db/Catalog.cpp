@@ -6,8 +6,9 @@ using namespace db;
 void Catalog::addTable(DbFile *file, const std::string &name, const std::string &pkeyField) {
     //Each table is constructed using the data in a file (DbFile). Therefore, the table ID becomes that file's ID.
     int tableId = file->getId();
-    auto *table = new Table(file, name, pkeyField);
-    tablesById[tableId] = table;
+    std::shared_ptr<const TupleDesc> td = intern(file->getTupleDesc());
+    file->setInternedTupleDesc(td);
+    tablesById[tableId] = std::make_unique<Table>(file, name, pkeyField, std::move(td));
     idByName[name] = tableId;
 }
 
@@ -22,11 +23,26 @@ int Catalog::getTableId(const std::string &name) const {
 }
 
 const TupleDesc &Catalog::getTupleDesc(int tableId) const {
+    return *getSharedTupleDesc(tableId);
+}
+
+const std::shared_ptr<const TupleDesc> &Catalog::getSharedTupleDesc(int tableId) const {
     auto it = tablesById.find(tableId);
     if(it == tablesById.end()) {
         throw std::invalid_argument("Table ID not found.");
     }
-    return it->second->file->getTupleDesc();
+    return it->second->td;
+}
+
+std::shared_ptr<const TupleDesc> Catalog::intern(const TupleDesc &td) {
+    // Tables are added rarely and few schemas are distinct, so a linear search is enough
+    for (const auto &schema : schemas) {
+        if (*schema == td) {
+            return schema;
+        }
+    }
+    schemas.push_back(std::make_shared<const TupleDesc>(td));
+    return schemas.back();
 }
 
 DbFile *Catalog::getDatabaseFile(int tableId) const {
@@ -56,4 +72,5 @@ std::string Catalog::getTableName(int id) const {
 void Catalog::clear() {
     tablesById.clear(); //tablesById in an unordered_map. Function unordered_map::clear() removes all elements from the container.
     idByName.clear();
+    schemas.clear();
 }
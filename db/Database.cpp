@@ -15,8 +15,9 @@ void Database::resetBufferPool(int pages) {
 }
 
 void Database::reset() {
-    catalog.~Catalog();
+    // The buffer pool goes first: its read-ahead threads look tables up in the catalog
     bufferpool.~BufferPool();
+    catalog.~Catalog();
     new(&catalog) Catalog;
     new(&bufferpool) BufferPool(BufferPool::DEFAULT_PAGES);
 }
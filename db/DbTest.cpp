@@ -0,0 +1,107 @@
+/**
+ * Regression checks for the db library. Each check prints its name and the
+ * driver exits with a non-zero status on the first failure.
+ *
+ * Usage: db_test
+ */
+#include <db/Database.h>
+#include <db/HeapFile.h>
+#include <db/RecordId.h>
+#include <db/SeqScan.h>
+#include <db/Utility.h>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+using namespace db;
+
+/** Fails the run if cond is false; unlike assert, also in release builds. */
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                   \
+        }                                                                              \
+    } while (false)
+
+/** RecordIds keep page numbers past 2^20 and the full 16 bits of the slot. */
+static void testRecordIdRange() {
+    RecordId far(-7, 1 << 20, 0);
+    CHECK(far.getTableId() == -7 && far.getPageNo() == 1 << 20 && far.getTupleno() == 0);
+    RecordId last(123456789, 0x7fffffff, (1 << RecordId::SLOT_BITS) - 1);
+    CHECK(last.getPageNo() == 0x7fffffff && last.getTupleno() == (1 << RecordId::SLOT_BITS) - 1);
+    CHECK(last.getPageId() == HeapPageId(123456789, 0x7fffffff));
+
+    CHECK(RecordId(-7, 5, 9) < far && far < RecordId(-7, (1 << 20) + 1, 0) && far < RecordId(1, 0, 0));
+    std::unordered_set<RecordId> ids;
+    for (int page = (1 << 20) - 50; page < (1 << 20) + 50; page++) {
+        for (int slot = 0; slot < 100; slot++) {
+            ids.insert(RecordId(3, page, slot));
+        }
+    }
+    CHECK(ids.size() == 10000 && ids.count(far) == 0 && ids.count(RecordId(3, 1 << 20, 7)) == 1);
+
+    bool threw = false;
+    try {
+        RecordId(1, 0, 1 << RecordId::SLOT_BITS);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    CHECK(threw);
+    printf("RecordId range ok\n");
+}
+
+/** Writes a table of numPages pages with every slot used and returns the number of rows. */
+static size_t createTable(const char *fname, const TupleDesc &td, int numPages) {
+    FILE *file = fopen(fname, "wb");
+    CHECK(file != nullptr);
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    TupleDesc::PageLayout layout = td.getPageLayout(pageSize);
+    std::vector<uint8_t> page(pageSize, 0);
+    for (int slot = 0; slot < layout.numSlots; slot++) {
+        page[slot / 8] |= 1 << (slot % 8);
+    }
+    for (int i = 0; i < numPages; i++) {
+        fwrite(page.data(), 1, page.size(), file);
+    }
+    fclose(file);
+    return static_cast<size_t>(layout.numSlots) * numPages;
+}
+
+/** A scan of a table larger than the pool reads through a ring, in prefetched windows. */
+static void testRingScanPrefetches() {
+    const char *fname = "db_test_ring.dat";
+    TupleDesc td = Utility::getTupleDesc(2);
+    size_t expected = createTable(fname, td, 200);
+    Database::reset();
+    HeapFile file(fname, td);
+    Database::getCatalog().addTable(&file, "ring");
+    Database::resetBufferPool(64);
+    BufferPool &pool = Database::getBufferPool();
+
+    TransactionId tid;
+    size_t rows = 0;
+    {
+        SeqScan scan(&tid, file.getId(), "ring");
+        for (auto it = scan.begin(); it != scan.end(); ++it) {
+            rows++;
+        }
+    }
+    CHECK(rows == expected);
+    CHECK(pool.getRingReadCount() == 200);
+    CHECK(pool.getPrefetchCount() > 0);
+    CHECK(pool.getNumCachedPages() == 0);
+    printf("ring scan prefetch ok (%zu pages prefetched)\n", pool.getPrefetchCount());
+
+    Database::reset();
+    remove(fname);
+}
+
+int main() {
+    testRecordIdRange();
+    testRingScanPrefetches();
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <db/FrameArena.h>
+#include <stdexcept>
+#include <sys/mman.h>
+
+using namespace db;
+
+FrameArena::FrameArena(size_t numFrames, size_t frameSize, bool useHugePages) : frameSize(frameSize) {
+    bytes = numFrames * frameSize;
+    if (useHugePages) {
+        // Huge pages are only used for whole 2MB extents
+        bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+    if (bytes == 0) {
+        return;
+    }
+
+    // Anonymous mappings are page aligned and zero filled. For huge pages,
+    // over-allocate and trim so the arena starts on a 2MB boundary.
+    size_t slack = useHugePages ? HUGE_PAGE_SIZE : 0;
+    void *memory = mmap(nullptr, bytes + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("FrameArena: cannot allocate buffer pool frames.");
+    }
+    auto address = reinterpret_cast<uintptr_t>(memory);
+    uintptr_t aligned = slack == 0 ? address : (address + slack - 1) / slack * slack;
+    if (aligned != address) {
+        munmap(memory, aligned - address);
+    }
+    if (slack != 0 && aligned + bytes != address + bytes + slack) {
+        munmap(reinterpret_cast<void *>(aligned + bytes), address + slack - aligned);
+    }
+    base = reinterpret_cast<uint8_t *>(aligned);
+
+#ifdef MADV_HUGEPAGE
+    if (useHugePages) {
+        hugePages = madvise(base, bytes, MADV_HUGEPAGE) == 0;
+    }
+#endif
+}
+
+FrameArena::~FrameArena() {
+    if (base != nullptr) {
+        munmap(base, bytes);
+    }
+}
@@ -3,18 +3,130 @@
 #include <db/Page.h>
 #include <db/PageId.h>
 #include <db/HeapPage.h>
+#include <db/IoUring.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 using namespace db;
 
+/** A heap buffer that can be used for O_DIRECT transfers. */
+using AlignedBuffer = std::unique_ptr<uint8_t, decltype(&free)>;
+
+static AlignedBuffer allocateAligned(size_t bytes) {
+    size_t rounded = (bytes + HeapFile::DIRECT_IO_ALIGNMENT - 1) / HeapFile::DIRECT_IO_ALIGNMENT * HeapFile::DIRECT_IO_ALIGNMENT;
+    void *memory = std::aligned_alloc(HeapFile::DIRECT_IO_ALIGNMENT, std::max(rounded, HeapFile::DIRECT_IO_ALIGNMENT));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return {static_cast<uint8_t *>(memory), &free};
+}
+
+/** O_DIRECT needs every transfer to cover whole aligned blocks. */
+static void checkDirectPageSize(size_t pageSize) {
+    if (pageSize % HeapFile::DIRECT_IO_ALIGNMENT != 0) {
+        throw std::logic_error("HeapFile: the page size is not a multiple of the O_DIRECT alignment.");
+    }
+}
+
 //
 // HeapFile
 //
 
-HeapFile::HeapFile(const char *fname, TupleDesc td): fname(fname), td(std::move(td)) {
+HeapFile::HeapFile(const char *fname, TupleDesc td, IoMode mode, PageFormat format)
+        : fname(fname), td(std::make_shared<const TupleDesc>(std::move(td))), mode(mode), format(format), fileSize(0) {
+    int direct = mode == IoMode::DIRECT ? O_DIRECT : 0;
+    if (mode == IoMode::MMAP) {
+        fd = open(fname, O_RDONLY | O_CLOEXEC);
+    } else {
+        fd = open(fname, O_RDWR | O_CREAT | O_CLOEXEC | direct, 0644);
+    }
+    if (fd == -1 && mode != IoMode::MMAP && (errno == EACCES || errno == EROFS)) {
+        // Read-only tables can still be scanned
+        fd = open(fname, O_RDONLY | O_CLOEXEC | direct);
+    }
+    if (fd == -1 && direct != 0 && errno == EINVAL) {
+        throw std::runtime_error("Cannot open file: the file system does not support O_DIRECT.");
+    }
+    if (fd == -1) {
+        throw std::runtime_error(std::string("Cannot open file: ") + strerror(errno));
+    }
+    try {
+        std::lock_guard<std::mutex> guard(mapLatch);
+        refreshSize();
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+}
+
+HeapFile::~HeapFile() {
+    for (const Mapping &m : mappings) {
+        munmap(m.base, m.length);
+    }
+    close(fd);
+}
+
+void HeapFile::refreshSize() const {
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+        throw std::runtime_error(std::string("Cannot stat file: ") + strerror(errno));
+    }
+    fileSize = st.st_size;
+    if (mode != IoMode::MMAP) {
+        return;
+    }
+
+    auto length = static_cast<size_t>(st.st_size);
+    if (length == 0 || (!mappings.empty() && mappings.back().length >= length)) {
+        return;
+    }
+    // Map the whole file again; pages read from older mappings stay valid
+    void *base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error(std::string("Cannot map file: ") + strerror(errno));
+    }
+    mappings.push_back({static_cast<uint8_t *>(base), length});
+}
+
+const uint8_t *HeapFile::mappedPage(int pageNo) const {
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    size_t end = (static_cast<size_t>(pageNo) + 1) * pageSize;
+
+    std::lock_guard<std::mutex> guard(mapLatch);
+    if (mappings.empty() || mappings.back().length < end) {
+        // The file may have grown since it was last mapped
+        refreshSize();
+    }
+    if (mappings.empty() || mappings.back().length < end) {
+        throw std::runtime_error("HeapFile: page is past the end of the file.");
+    }
+    return mappings.back().base + end - pageSize;
+}
+
+void HeapFile::willNeed(int firstPage, int numPages) const {
+    if (mode != IoMode::MMAP || numPages <= 0) {
+        return;
+    }
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    std::lock_guard<std::mutex> guard(mapLatch);
+    if (mappings.empty()) {
+        return;
+    }
+    const Mapping &m = mappings.back();
+    size_t begin = static_cast<size_t>(firstPage) * pageSize;
+    size_t end = std::min(m.length, begin + static_cast<size_t>(numPages) * pageSize);
+    if (begin < end) {
+        // The mapping starts page aligned and pageSize is a multiple of the system page
+        madvise(m.base + begin, end - begin, MADV_WILLNEED);
+    }
 }
 
 int HeapFile::getId() const {
@@ -22,33 +134,190 @@ int HeapFile::getId() const {
 }
 
 const TupleDesc &HeapFile::getTupleDesc() const {
-    return td;
+    return *td;
 }
 
-Page *HeapFile::readPage(const PageId &pid) const {
-    int pageSize = Database::getBufferPool().getPageSize();
-    int offset = pid.pageNumber() * pageSize;
+void HeapFile::setInternedTupleDesc(std::shared_ptr<const TupleDesc> interned) {
+    td = std::move(interned);
+}
+
+void HeapFile::readPageData(int pageNo, uint8_t *data) const {
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    if (mode == IoMode::MMAP) {
+        memcpy(data, mappedPage(pageNo), pageSize);
+        return;
+    }
+    if (mode == IoMode::DIRECT) {
+        checkDirectPageSize(pageSize);
+    }
+    // 64-bit offset: pageNo * pageSize overflows int past 2GB
+    off_t offset = static_cast<off_t>(pageNo) * static_cast<off_t>(pageSize);
+
+    size_t done = 0;
+    while (done < pageSize) {
+        ssize_t n = pread(fd, data + done, pageSize - done, offset + static_cast<off_t>(done));
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Cannot read from file: ") + strerror(errno));
+        }
+        if (n == 0 || (mode == IoMode::DIRECT && static_cast<size_t>(n) < pageSize - done)) {
+            // End of file. With O_DIRECT, a short read only happens there, and
+            // reading on from an unaligned offset would fail.
+            memset(data + done + n, 0, pageSize - done - n);
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+}
 
-    std::ifstream file(fname, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Cannot open file for reading.");
+TuplePage *HeapFile::newPage(const HeapPageId &pid, uint8_t *data, bool inPlace) const {
+    switch (format) {
+        case PageFormat::SLOTTED:
+            return new SlottedPage(pid, data, inPlace);
+        case PageFormat::PAX:
+            return new PaxPage(pid, data, inPlace);
+        default:
+            return new HeapPage(pid, data, inPlace);
     }
+}
+
+Page *HeapFile::readPage(const PageId &pid) const {
+    // Aligned, in case the file is opened with O_DIRECT
+    AlignedBuffer data = allocateAligned(Database::getBufferPool().getPageSize());
+    readPageData(pid.pageNumber(), data.get());
 
-    file.seekg(offset);
-    auto* data = new uint8_t[pageSize];
-    file.read(reinterpret_cast<char*>(data), pageSize);
+    // The page copies what it keeps
+    HeapPageId hpid(getId(), pid.pageNumber());
+    return newPage(hpid, data.get(), false);
+}
 
+Page *HeapFile::readPage(const PageId &pid, uint8_t *frame) const {
     HeapPageId hpid(getId(), pid.pageNumber());
-    return new HeapPage(hpid, data);
+    if (mode == IoMode::MMAP) {
+        // The mapping is read-only: pages of a read-only file never write to their data
+        return newPage(hpid, const_cast<uint8_t *>(mappedPage(pid.pageNumber())), true);
+    }
+
+    readPageData(pid.pageNumber(), frame);
+    return newPage(hpid, frame, true);
+}
+
+std::vector<Page *> HeapFile::readPages(int firstPage, int count, const std::vector<uint8_t *> &frames) const {
+    std::vector<Page *> pages;
+    pages.reserve(count);
+    try {
+        if (mode != IoMode::MMAP) {
+            size_t pageSize = Database::getBufferPool().getPageSize();
+            std::vector<IoUring::Read> reads;
+            reads.reserve(count);
+            for (int i = 0; i < count; i++) {
+                off_t offset = static_cast<off_t>(firstPage + i) * static_cast<off_t>(pageSize);
+                reads.push_back({fd, frames[i], pageSize, offset});
+            }
+            IoUring &ring = IoUring::forThisThread();
+            bool ringRead = false;
+            if (ring.available()) {
+                try {
+                    ring.read(reads);
+                    ringRead = true;
+                } catch (const std::runtime_error &) {
+                    // The ring gave up on the batch and is no longer usable; pread all of it
+                }
+            }
+            for (int i = 0; i < count; i++) {
+                if (!ringRead || reads[i].result != static_cast<ssize_t>(pageSize)) {
+                    // Short read, end of file or error: let pread finish it or report it
+                    readPageData(firstPage + i, frames[i]);
+                }
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            HeapPageId hpid(getId(), firstPage + i);
+            if (mode == IoMode::MMAP) {
+                pages.push_back(newPage(hpid, const_cast<uint8_t *>(mappedPage(firstPage + i)), true));
+            } else {
+                pages.push_back(newPage(hpid, frames[i], true));
+            }
+        }
+    } catch (...) {
+        for (Page *page : pages) {
+            delete page;
+        }
+        throw;
+    }
+    return pages;
+}
+
+void HeapFile::writePage(Page *page) const {
+    writePages({page});
+}
+
+void HeapFile::writePages(const std::vector<Page *> &pages) const {
+    if (mode == IoMode::MMAP) {
+        throw std::logic_error("HeapFile: a memory-mapped file is read-only.");
+    }
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    if (mode == IoMode::DIRECT) {
+        checkDirectPageSize(pageSize);
+    }
+
+    // One aligned buffer big enough for the longest run, in case of O_DIRECT
+    size_t longestRun = 1;
+    for (size_t i = 0, length = 1; i + 1 < pages.size(); i++) {
+        length = pages[i + 1]->getId().pageNumber() == pages[i]->getId().pageNumber() + 1 ? length + 1 : 1;
+        longestRun = std::max(longestRun, length);
+    }
+    AlignedBuffer run = allocateAligned(longestRun * pageSize);
+
+    size_t i = 0;
+    while (i < pages.size()) {
+        // Collect the run of consecutive page numbers starting at pages[i]
+        int first = pages[i]->getId().pageNumber();
+        size_t count = 1;
+        while (i + count < pages.size() && pages[i + count]->getId().pageNumber() == first + static_cast<int>(count)) {
+            count++;
+        }
+
+        size_t runBytes = count * pageSize;
+        for (size_t j = 0; j < count; j++) {
+            auto *data = static_cast<uint8_t *>(pages[i + j]->getPageData());
+            memcpy(run.get() + j * pageSize, data, pageSize);
+            delete[] data;
+        }
+
+        off_t offset = static_cast<off_t>(first) * static_cast<off_t>(pageSize);
+        size_t done = 0;
+        while (done < runBytes) {
+            ssize_t n = pwrite(fd, run.get() + done, runBytes - done, offset + static_cast<off_t>(done));
+            if (n == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Cannot write to file: ") + strerror(errno));
+            }
+            done += static_cast<size_t>(n);
+        }
+
+        // Appending grows the cached size; concurrent writers keep the largest end
+        off_t end = offset + static_cast<off_t>(runBytes);
+        off_t size = fileSize.load();
+        while (size < end && !fileSize.compare_exchange_weak(size, end)) {
+        }
+        i += count;
+    }
 }
 
 int HeapFile::getNumPages() const {
-    std::ifstream file(fname, std::ios::binary | std::ios::ate);
-    int fileSize = file.tellg();
-    return fileSize / Database::getBufferPool().getPageSize();
+    return static_cast<int>(fileSize.load() / static_cast<off_t>(Database::getBufferPool().getPageSize()));
 }
 
 HeapFileIterator HeapFile::begin() const {
+    if (mode == IoMode::MMAP) {
+        std::lock_guard<std::mutex> guard(mapLatch);
+        refreshSize();
+    }
     return {this, 0};
 }
 
@@ -60,46 +329,131 @@ HeapFileIterator HeapFile::end() const {
 // HeapFileIterator
 //
 
-HeapFileIterator::HeapFileIterator(const HeapFile *heapFile, int currentPage)
-    : heapFile(heapFile), currentPage(currentPage) {
+HeapFileIterator::HeapFileIterator(const HeapFile *heapFile, int currentPage, const TransactionId &tid,
+                                   const std::vector<Predicate> *predicates, const Projection *projection)
+    : heapFile(heapFile), tid(tid), currentPage(currentPage), numPages(heapFile->getNumPages()),
+      predicates(predicates), projection(projection) {
+    if (projection != nullptr) {
+        projected = Tuple(projection->getTupleDesc());
+    }
+    if (currentPage < numPages) {
+        ring = Database::getBufferPool().createScanRing(numPages);
+        // Ask for the first two windows up front, then one window ahead as the scan moves
+        heapFile->willNeed(currentPage, 2 * Database::getBufferPool().getPrefetchDepth());
+    }
+    seekNonEmptyPage();
 }
 
-bool HeapFileIterator::operator!=(const HeapFileIterator &other) const {
-    return currentPage != other.currentPage || heapFile != other.heapFile;
+void HeapFileIterator::seekNonEmptyPage() {
+    int window = Database::getBufferPool().getPrefetchDepth();
+    slotIndex = 0;
+    projectedValid = false;
+    for (; currentPage < numPages; currentPage++) {
+        if (window > 0 && currentPage % window == 0) {
+            heapFile->willNeed(currentPage + window, window);
+        }
+        // Pin the page through the buffer pool; the previous pin is released
+        guard = Database::getBufferPool().fetchPage(tid, HeapPageId(heapFile->getId(), currentPage), ring.get());
+        const auto *page = dynamic_cast<const TuplePage *>(guard.get());
+        page->getUsedSlots(slots);
+        if (predicates != nullptr) {
+            for (const Predicate &predicate : *predicates) {
+                predicate.filter(*page, slots);
+            }
+        }
+        if (!slots.empty()) {
+            return;
+        }
+    }
+    slots.clear();
+    guard.release();
 }
 
-Tuple &HeapFileIterator::operator*() {
-    // Use HeapPageId to construct the specific type of PageId
-    //HeapPageId hpid(heapFile->getId(), currentPage);
-
-    // Fetch the current page
-    //HeapPage *page = dynamic_cast<HeapPage*>(heapFile->readPage(hpid));
-
-    // This assumes HeapPage has an appropriate method to fetch the tuple by index
-    //return page->getTuple(currentTupleIndex);
+HeapFileIterator &HeapFileIterator::operator=(HeapFileIterator &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    // guard may pin a frame of ring, so it has to go first
+    guard.release();
+    heapFile = other.heapFile;
+    tid = other.tid;
+    currentPage = other.currentPage;
+    numPages = other.numPages;
+    predicates = other.predicates;
+    projection = other.projection;
+    projected = std::move(other.projected);
+    projectedValid = other.projectedValid;
+    ring = std::move(other.ring);
+    guard = std::move(other.guard);
+    slots = std::move(other.slots);
+    slotIndex = other.slotIndex;
+    batchSlots = std::move(other.batchSlots);
+    return *this;
+}
 
-    // First, read the page using the current page number
-    Page *pagePtr = heapFile->readPage(HeapPageId(heapFile->getId(), currentPage));
-    HeapPage *page = dynamic_cast<HeapPage*>(pagePtr);
+bool HeapFileIterator::operator!=(const HeapFileIterator &other) const {
+    if (currentPage != other.currentPage || heapFile != other.heapFile) {
+        return true;
+    }
+    return slotIndex != other.slotIndex || slots.empty() != other.slots.empty();
+}
 
-    // Next, retrieve the tuple from the page using the iterator
-    HeapPageIterator it = page->begin();
-    return *it;
+Tuple &HeapFileIterator::operator*() const {
+    const auto *page = dynamic_cast<const TuplePage *>(guard.get());
+    int slot = slots[slotIndex];
+    if (projection == nullptr) {
+        return page->getTuple(slot);
+    }
+    if (!projectedValid) {
+        // Read only the projected fields, reusing the memory of the previous row
+        projected.clear();
+        RecordId rid(HeapPageId(heapFile->getId(), currentPage), slot);
+        projected.setRecordId(&rid);
+        const std::vector<int> &columns = projection->getColumns();
+        const TupleDesc &td = *projection->getTupleDesc();
+        for (size_t i = 0; i < columns.size(); i++) {
+            int field = static_cast<int>(i);
+            if (td.getFieldType(i) == Types::INT_TYPE) {
+                projected.setInt(field, page->getInt(slot, columns[i]));
+            } else {
+                projected.setString(field, page->getStringView(slot, columns[i]));
+            }
+        }
+        projectedValid = true;
+    }
+    return projected;
 }
 
 HeapFileIterator &HeapFileIterator::operator++() {
-    // First, read the page using the current page number
-    Page *pagePtr = heapFile->readPage(HeapPageId(heapFile->getId(), currentPage));
-    HeapPage *page = dynamic_cast<HeapPage*>(pagePtr);
-
-    // Increment the internal page iterator
-    HeapPageIterator it = page->begin();
-    ++it;
-
-    // If we've reached the end of the current page, go to the next page
-    if (it != page->end()) {
+    projectedValid = false;
+    // Move to the next matching slot; if we've reached the end of the current page, go to the next page
+    if (++slotIndex == slots.size()) {
         currentPage++;
+        seekNonEmptyPage();
     }
-
     return *this;
 }
+
+size_t HeapFileIterator::nextBatch(TupleBatch &batch) {
+    const TupleDesc &td = projection != nullptr ? *projection->getTupleDesc() : heapFile->getTupleDesc();
+    if (!(batch.getTupleDesc() == td)) {
+        throw std::invalid_argument("HeapFileIterator: batch has a different schema.");
+    }
+    batch.clear();
+    while (!slots.empty() && !batch.isFull() && batch.getNumPages() < TupleBatch::MAX_PAGES) {
+        size_t count = std::min(batch.getCapacity() - batch.size(), slots.size() - slotIndex);
+        batchSlots.assign(slots.begin() + slotIndex, slots.begin() + slotIndex + count);
+
+        // The batch pins the page too, so its rows outlive the iterator moving on
+        HeapPageId pid(heapFile->getId(), currentPage);
+        batch.append(Database::getBufferPool().fetchPage(tid, pid, ring.get()), batchSlots,
+                     projection != nullptr ? &projection->getColumns() : nullptr, ring);
+        slotIndex += count;
+        projectedValid = false;
+        if (slotIndex == slots.size()) {
+            currentPage++;
+            seekNonEmptyPage();
+        }
+    }
+    return batch.size();
+}
@@ -1,98 +1,174 @@
 #include <db/HeapPage.h>
+#include <algorithm>
 
 using namespace db;
 
-HeapPageIterator::HeapPageIterator(int i, const HeapPage *page) {
-    this->slot = i;
-    this->page = page;
-    while (slot < page->numSlots && !page->isSlotUsed(slot)) {
-        slot++;
-    }
+HeapPage::HeapPage(const HeapPageId &id, uint8_t *data) : HeapPage(id, data, false, false) {
 }
 
-bool HeapPageIterator::operator!=(const HeapPageIterator &other) const {
-    return slot != other.slot || page != other.page;
+HeapPage::HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace) : HeapPage(id, data, inPlace, false) {
 }
 
-HeapPageIterator &HeapPageIterator::operator++() {
-    do {
-        slot++;
-    } while (slot < page->numSlots && !page->isSlotUsed(slot));
-    return *this;
+HeapPage::HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar)
+        : HeapPage(id, data, inPlace, columnar, Database::getBufferPool().getPageSize()) {
 }
 
-Tuple &HeapPageIterator::operator*() const {
-    return page->tuples[slot];
+HeapPage::HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar, size_t pageSize)
+        : HeapPage(id, data, inPlace, columnar, pageSize, Database::getCatalog().getSharedTupleDesc(id.getTableId())) {
 }
 
-HeapPage::HeapPage(const HeapPageId &id, uint8_t *data) : pid(id) {
-    this->td = Database::getCatalog().getTupleDesc(id.getTableId());
-    this->numSlots = static_cast<int>(getNumTuples());
+HeapPage::HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar, size_t pageSize,
+                   const std::shared_ptr<const TupleDesc> &td)
+        : TuplePage(td->getPageLayout(pageSize).numSlots), pid(id), td(td), ownsData(!inPlace) {
+    TupleDesc::PageLayout pageLayout = td->getPageLayout(pageSize);
+    this->tupleSize = td->getSize();
+    this->numSlots = pageLayout.numSlots;
+    this->headerSize = pageLayout.headerSize;
 
-    // Allocate and read the header slots of this page
-    size_t header_size = getHeaderSize();
-    header = new uint8_t[header_size];
-    memcpy(header, data, header_size);
-    size_t offset = header_size;
+    // Keep the page bytes, in place or as a copy; tuples are decoded from them on demand
+    if (inPlace) {
+        this->data = data;
+    } else {
+        this->data = new uint8_t[pageSize];
+        memcpy(this->data, data, pageSize);
+    }
 
-    tuples = new Tuple[numSlots];
-    for (int slot = 0; slot < numSlots; slot++) {
-        if (isSlotUsed(slot)) {
-            readTuple(tuples + slot, data + offset, slot);
+    // Row layout: tuple after tuple. Columnar: all values of a field, then the next field.
+    size_t offset = headerSize;
+    for (size_t i = 0; i < td->numFields(); i++) {
+        Types::Type type = td->getFieldType(i);
+        if (columnar) {
+            size_t len = Types::getLen(type);
+            layout.push_back({offset, len, type});
+            offset += numSlots * len;
+        } else {
+            layout.push_back({headerSize + td->getFieldOffset(i), tupleSize, type});
         }
-        offset += td.getSize();
+    }
+}
+
+HeapPage::~HeapPage() {
+    if (ownsData) {
+        delete[] data;
     }
 }
 
 size_t HeapPage::getNumTuples() {
-    return (Database::getBufferPool().getPageSize() * 8) / (td.getSize() * 8 + 1);
+    return numSlots;
 }
 
 int HeapPage::getHeaderSize() {
-    return (int)ceil((double)getNumTuples() / 8);
+    return headerSize;
 }
 
 PageId &HeapPage::getId() {
     return pid;
 }
 
-void HeapPage::readTuple(Tuple *t, uint8_t *data, int slotId) {
-    new(t) Tuple(td, new RecordId(&pid, slotId));
-    int i = 0;
-    for (const auto &item: td) {
-        Types::Type type = item.fieldType;
-        const Field *f = Types::parse(data, type);
-        data += Types::getLen(type);
-        t->setField(i, f);
-        i++;
+Tuple *HeapPage::readTuple(int slotId) const {
+    Tuple *t = newTuple(td, RecordId(pid, slotId));
+    for (size_t i = 0; i < layout.size(); i++) {
+        int col = static_cast<int>(i);
+        if (layout[i].type == Types::INT_TYPE) {
+            t->setInt(col, getInt(slotId, col));
+        } else {
+            t->setString(col, getStringView(slotId, col));
+        }
+    }
+    return t;
+}
+
+const uint8_t *HeapPage::fieldData(int slot, int col, Types::Type type) const {
+    if (slot < 0 || slot >= numSlots || col < 0 || col >= static_cast<int>(layout.size())) {
+        throw std::out_of_range("HeapPage: slot or field index out of range.");
+    }
+    if (layout[col].type != type) {
+        throw std::invalid_argument("HeapPage: field has a different type.");
+    }
+    return fieldAt(slot, col);
+}
+
+int HeapPage::getInt(int slot, int col) const {
+    int value;
+    memcpy(&value, fieldData(slot, col, Types::INT_TYPE), sizeof(int));
+    return value;
+}
+
+std::string_view HeapPage::getStringView(int slot, int col) const {
+    const uint8_t *field = fieldData(slot, col, Types::STRING_TYPE);
+    int len;
+    memcpy(&len, field, sizeof(int));
+    len = std::max(0, std::min(len, static_cast<int>(Types::STRING_LEN) - 1));
+    return {reinterpret_cast<const char *>(field + sizeof(int)), static_cast<size_t>(len)};
+}
+
+void HeapPage::readIntColumn(int col, const int *slots, size_t count, int32_t *out) const {
+    if (count == 0) {
+        return;
+    }
+    static_cast<void>(fieldData(slots[0], col, Types::INT_TYPE)); // Checks col and its type once
+    // The values of a field are stride bytes apart; in a PaxPage they are contiguous
+    const FieldLayout &field = layout[col];
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i] < 0 || slots[i] >= numSlots) {
+            throw std::out_of_range("HeapPage: slot or field index out of range.");
+        }
+        memcpy(&out[i], data + field.offset + slots[i] * field.stride, sizeof(int32_t));
+    }
+}
+
+void HeapPage::readStringColumn(int col, const int *slots, size_t count, std::string_view *out) const {
+    if (count == 0) {
+        return;
+    }
+    static_cast<void>(fieldData(slots[0], col, Types::STRING_TYPE)); // Checks col and its type once
+    const FieldLayout &field = layout[col];
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i] < 0 || slots[i] >= numSlots) {
+            throw std::out_of_range("HeapPage: slot or field index out of range.");
+        }
+        const uint8_t *value = data + field.offset + slots[i] * field.stride;
+        int len;
+        memcpy(&len, value, sizeof(int));
+        len = std::max(0, std::min(len, static_cast<int>(Types::STRING_LEN) - 1));
+        out[i] = {reinterpret_cast<const char *>(value + sizeof(int)), static_cast<size_t>(len)};
     }
 }
 
 void *HeapPage::getPageData() {
-    auto *data = createEmptyPageData();
-    size_t header_size = getHeaderSize();
-
-    // Create the header of the page
-    memcpy(data, header, header_size);
-    size_t offset = header_size;
-    // Create the tuples
-    for (int i = 0; i < numSlots; i++) {
-        const Tuple &tuple = tuples[i];
-        // Empty slot
-        if (!isSlotUsed(i)) {
-            memset(data + offset, 0, td.getSize());
-            offset += td.getSize();
-        } else {
-            // Non-empty slot
-            for (int j = 0; j < td.numFields(); j++) {
-                const Field &f = tuple.getField(j);
-                f.serialize(data + offset);
-                offset += Types::getLen(f.getType());
+    auto *pageData = createEmptyPageData();
+
+    // The header and the fields of used slots as read; unused slots are left zeroed
+    memcpy(pageData, data, headerSize);
+    for (int slot = 0; slot < numSlots; slot++) {
+        if (!isSlotUsed(slot)) {
+            continue;
+        }
+        const Tuple *tuple = decodedTuple(slot);
+        for (int j = 0; j < static_cast<int>(layout.size()); j++) {
+            size_t offset = fieldAt(slot, j) - data;
+            if (tuple == nullptr) {
+                memcpy(pageData + offset, data + offset, Types::getLen(layout[j].type));
+            } else {
+                // A decoded tuple may have been changed through setField
+                tuple->serializeField(j, pageData + offset);
             }
         }
     }
 
-    return data;
+    return pageData;
+}
+
+void HeapPage::markDirty(bool dirty, const TransactionId &tid) {
+    if (dirty) {
+        dirtier = tid;
+    } else {
+        dirtier.reset();
+    }
+}
+
+const TransactionId *HeapPage::isDirty() const {
+    return dirtier ? &*dirtier : nullptr;
 }
 
 uint8_t *HeapPage::createEmptyPageData() {
@@ -100,23 +176,88 @@ uint8_t *HeapPage::createEmptyPageData() {
     return new uint8_t[len]{}; // all 0
 }
 
+uint64_t HeapPage::headerWord(int word) const {
+    // The header is a byte array with slot i in bit i % 8 of byte i / 8, so
+    // loading 8 bytes little-endian puts slot 64 * word + i in bit i
+    size_t first = static_cast<size_t>(word) * sizeof(uint64_t);
+    size_t bytes = std::min(sizeof(uint64_t), static_cast<size_t>(headerSize) - first);
+    uint64_t bits = 0;
+    memcpy(&bits, data + first, bytes);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    bits = __builtin_bswap64(bits);
+#endif
+    int slotsLeft = numSlots - word * 64;
+    if (slotsLeft < 64) {
+        // Ignore the padding bits of the last header byte
+        bits &= (uint64_t(1) << slotsLeft) - 1;
+    }
+    return bits;
+}
+
 int HeapPage::getNumEmptySlots() const {
-    int count = 0;
-    for (int i = 0; i < numSlots; i++) {
-        if (!isSlotUsed(i)) count++;
+    int used = 0;
+    int numWords = (numSlots + 63) / 64;
+    for (int word = 0; word < numWords; word++) {
+        used += __builtin_popcountll(headerWord(word));
     }
-    return count;
+    return numSlots - used;
 }
 
 bool HeapPage::isSlotUsed(int i) const {
-    int headerBit = (header[i/8] >> (i % 8)) & 1;
+    int headerBit = (data[i/8] >> (i % 8)) & 1;
     return headerBit == 1;
 }
 
-HeapPageIterator HeapPage::begin() const {
-    return {0, this};
+int HeapPage::nextUsedSlot(int from) const {
+    if (from >= numSlots) {
+        return numSlots;
+    }
+    int word = from / 64;
+    // Drop the slots before from in the first word
+    uint64_t bits = headerWord(word) & (~uint64_t(0) << (from % 64));
+    int numWords = (numSlots + 63) / 64;
+    while (bits == 0) {
+        if (++word == numWords) {
+            return numSlots;
+        }
+        bits = headerWord(word);
+    }
+    return word * 64 + __builtin_ctzll(bits);
+}
+
+int HeapPage::nextFreeSlot(int from) const {
+    if (from >= numSlots) {
+        return -1;
+    }
+    int word = from / 64;
+    int numWords = (numSlots + 63) / 64;
+    // Look for a zero bit: search the used bits inverted, without the slots before from
+    uint64_t free = ~headerWord(word) & (~uint64_t(0) << (from % 64));
+    while (true) {
+        int slotsLeft = numSlots - word * 64;
+        if (slotsLeft < 64) {
+            // The padding bits read as zero, so they look free: drop them
+            free &= (uint64_t(1) << slotsLeft) - 1;
+        }
+        if (free != 0) {
+            return word * 64 + __builtin_ctzll(free);
+        }
+        if (++word == numWords) {
+            return -1;
+        }
+        free = ~headerWord(word);
+    }
 }
 
-HeapPageIterator HeapPage::end() const {
-    return {numSlots, this};
+size_t HeapPage::getUsedSlots(std::vector<int> &slots) const {
+    slots.clear();
+    int numWords = (numSlots + 63) / 64;
+    for (int word = 0; word < numWords; word++) {
+        uint64_t bits = headerWord(word);
+        while (bits != 0) {
+            slots.push_back(word * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1; // Clear the lowest set bit
+        }
+    }
+    return slots.size();
 }
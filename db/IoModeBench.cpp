@@ -0,0 +1,117 @@
+/**
+ * Compares the HeapFile I/O modes (buffered, O_DIRECT and mmap) on a full
+ * SeqScan and on random page reads through a small BufferPool. Before each
+ * run the file is dropped from the kernel page cache, so every mode starts
+ * cold.
+ *
+ * Usage: io_mode_bench [file] [table pages] [pool pages] [random reads]
+ */
+#include <db/Database.h>
+#include <db/HeapFile.h>
+#include <db/HeapPageId.h>
+#include <db/SeqScan.h>
+#include <db/Utility.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <memory>
+#include <random>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace db;
+
+/** Writes a table of numPages pages with every slot used. */
+static void createTable(const char *fname, const TupleDesc &td, int numPages) {
+    FILE *file = fopen(fname, "wb");
+    if (file == nullptr) {
+        perror(fname);
+        exit(1);
+    }
+    size_t pageSize = Database::getBufferPool().getPageSize();
+    TupleDesc::PageLayout layout = td.getPageLayout(pageSize);
+    std::vector<uint8_t> page(pageSize, 0);
+    for (int slot = 0; slot < layout.numSlots; slot++) {
+        page[slot / 8] |= 1 << (slot % 8);
+    }
+    for (int i = 0; i < numPages; i++) {
+        fwrite(page.data(), 1, page.size(), file);
+    }
+    fclose(file);
+}
+
+/** Evicts the file from the kernel page cache. */
+static void dropCache(const char *fname) {
+    int fd = open(fname, O_RDONLY);
+    if (fd != -1) {
+        fsync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *fname = argc > 1 ? argv[1] : "io_mode_bench.dat";
+    int numPages = argc > 2 ? atoi(argv[2]) : 16384;
+    int poolPages = argc > 3 ? atoi(argv[3]) : 1024;
+    int numReads = argc > 4 ? atoi(argv[4]) : 20000;
+
+    TupleDesc td = Utility::getTupleDesc(2);
+    createTable(fname, td, numPages);
+
+    const std::vector<std::pair<const char *, IoMode>> modes = {
+            {"buffered", IoMode::BUFFERED},
+            {"O_DIRECT", IoMode::DIRECT},
+            {"mmap", IoMode::MMAP},
+    };
+
+    printf("%d pages, %d pool pages, %d random reads\n", numPages, poolPages, numReads);
+    printf("%10s %12s %14s %16s\n", "mode", "scan ms", "scan MB/s", "random reads/s");
+    // The Catalog does not own its files, so each one is kept alive until the
+    // Database::reset that drops it from the catalog
+    std::unique_ptr<HeapFile> file;
+    for (const auto &[name, mode] : modes) {
+        Database::reset();
+        try {
+            file = std::make_unique<HeapFile>(fname, td, mode);
+        } catch (const std::exception &e) {
+            file.reset();
+            printf("%10s %s\n", name, e.what());
+            continue;
+        }
+        Database::getCatalog().addTable(file.get(), "bench");
+        TransactionId tid;
+
+        dropCache(fname);
+        Database::resetBufferPool(poolPages);
+        auto start = std::chrono::steady_clock::now();
+        size_t rows = 0;
+        SeqScan scan(&tid, file->getId(), "bench");
+        for (auto it = scan.begin(); it != scan.end(); ++it) {
+            rows++;
+        }
+        std::chrono::duration<double> scanTime = std::chrono::steady_clock::now() - start;
+
+        dropCache(fname);
+        Database::resetBufferPool(poolPages);
+        BufferPool &pool = Database::getBufferPool();
+        pool.setPrefetchDepth(0);
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> pageNo(0, numPages - 1);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numReads; i++) {
+            PageGuard guard = pool.fetchPage(tid, HeapPageId(file->getId(), pageNo(random)));
+        }
+        std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - start;
+
+        double megabytes = static_cast<double>(numPages) * static_cast<double>(pool.getPageSize()) / (1024 * 1024);
+        printf("%10s %12.1f %14.1f %16.0f   (%zu rows)\n", name, scanTime.count() * 1000,
+               megabytes / scanTime.count(), numReads / readTime.count(), rows);
+    }
+    Database::reset();
+    remove(fname);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <db/IoUring.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace db;
+
+IoUring::IoUring(unsigned entries) {
+    io_uring_params params{};
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        // Not supported or disabled by the administrator
+        return;
+    }
+    ringFd = fd;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sq = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    void *cq = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void *entriesMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    sqRing = sq == MAP_FAILED ? nullptr : sq;
+    cqRing = cq == MAP_FAILED ? nullptr : cq;
+    sqes = entriesMemory == MAP_FAILED ? nullptr : static_cast<io_uring_sqe *>(entriesMemory);
+    if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr) {
+        close();
+        return;
+    }
+
+    auto *sqBytes = static_cast<uint8_t *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sqBytes + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sqBytes + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned *>(sqBytes + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqArray = reinterpret_cast<unsigned *>(sqBytes + params.sq_off.array);
+
+    auto *cqBytes = static_cast<uint8_t *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cqBytes + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cqBytes + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cqBytes + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cqBytes + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    close();
+}
+
+void IoUring::close() {
+    if (sqes != nullptr) {
+        munmap(sqes, sqesSize);
+        sqes = nullptr;
+    }
+    if (cqRing != nullptr) {
+        munmap(cqRing, cqRingSize);
+        cqRing = nullptr;
+    }
+    if (sqRing != nullptr) {
+        munmap(sqRing, sqRingSize);
+        sqRing = nullptr;
+    }
+    if (ringFd != -1) {
+        ::close(ringFd);
+        ringFd = -1;
+    }
+}
+
+void IoUring::read(std::vector<Read> &reads) {
+    if (!available()) {
+        throw std::runtime_error("IoUring: io_uring is not available.");
+    }
+
+    size_t next = 0;
+    while (next < reads.size()) {
+        auto batch = static_cast<unsigned>(std::min<size_t>(sqEntries, reads.size() - next));
+
+        // Only this thread produces submissions, so the tail can be read plainly
+        unsigned tail = *sqTail;
+        for (unsigned i = 0; i < batch; i++) {
+            const Read &r = reads[next + i];
+            unsigned index = (tail + i) & sqMask;
+            io_uring_sqe &sqe = sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = r.fd;
+            sqe.addr = reinterpret_cast<uint64_t>(r.buffer);
+            sqe.len = static_cast<uint32_t>(r.length);
+            sqe.off = static_cast<uint64_t>(r.offset);
+            sqe.user_data = next + i;
+            sqArray[index] = index;
+        }
+        // Publish the entries before the kernel can see the new tail
+        __atomic_store_n(sqTail, tail + batch, __ATOMIC_RELEASE);
+
+        // Submit everything and wait for all of it in as few calls as possible
+        unsigned toSubmit = batch;
+        unsigned completed = 0;
+        while (completed < batch) {
+            unsigned head = __atomic_load_n(cqHead, __ATOMIC_RELAXED);
+            if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+                long ret = syscall(__NR_io_uring_enter, ringFd, toSubmit, batch - completed,
+                                   IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (ret < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    int error = errno;
+                    // The kernel may still write into the buffers of the reads
+                    // it accepted, so wait for them before giving up on the ring
+                    drain(batch - toSubmit - completed);
+                    close();
+                    throw std::runtime_error(std::string("IoUring: io_uring_enter failed: ") + strerror(error));
+                }
+                toSubmit -= std::min(toSubmit, static_cast<unsigned>(ret));
+                continue;
+            }
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            reads[cqe.user_data].result = cqe.res;
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            completed++;
+        }
+        next += batch;
+    }
+}
+
+void IoUring::drain(unsigned inFlight) {
+    while (inFlight > 0) {
+        unsigned head = __atomic_load_n(cqHead, __ATOMIC_RELAXED);
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            long ret = syscall(__NR_io_uring_enter, ringFd, 0, inFlight, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret < 0 && errno != EINTR) {
+                // Nothing more can be done; closing the ring cancels the rest
+                return;
+            }
+            continue;
+        }
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        inFlight--;
+    }
+}
+
+IoUring &IoUring::forThisThread() {
+    thread_local IoUring ring;
+    return ring;
+}
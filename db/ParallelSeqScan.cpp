@@ -0,0 +1,179 @@
+#include <db/ParallelSeqScan.h>
+#include <db/Database.h>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace db;
+
+ParallelSeqScan::ParallelSeqScan(TransactionId *tid, int tableid, int numWorkers, int morselPages)
+        : tid(tid), tableid(tableid), numWorkers(numWorkers), morselPages(morselPages) {
+    if (numWorkers < 0 || morselPages <= 0) {
+        throw std::invalid_argument("ParallelSeqScan: invalid number of workers or morsel size.");
+    }
+    if (numWorkers == 0) {
+        this->numWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+const HeapFile *ParallelSeqScan::scannedFile() const {
+    const auto *file = dynamic_cast<const HeapFile *>(Database::getCatalog().getDatabaseFile(tableid));
+    if (file == nullptr) {
+        throw std::runtime_error("ParallelSeqScan: table is not a HeapFile.");
+    }
+    return file;
+}
+
+int ParallelSeqScan::workersFor(int numMorsels) const {
+    return std::max(1, std::min(numWorkers, numMorsels));
+}
+
+/** Calls f for every tuple of pages [first, end) of file, read through ring unless it is null. */
+template<typename F>
+static void scanPages(const HeapFile *file, const TransactionId &tid, int first, int end, ScanRing *ring, F &&f) {
+    file->willNeed(first, end - first);
+    for (int pageNo = first; pageNo < end; pageNo++) {
+        PageGuard guard = Database::getBufferPool().fetchPage(tid, HeapPageId(file->getId(), pageNo), ring);
+        const auto *page = dynamic_cast<const TuplePage *>(guard.get());
+        for (const Tuple &tuple : *page) {
+            f(tuple);
+        }
+    }
+}
+
+void ParallelSeqScan::run(const std::function<void(int worker, const Tuple &tuple)> &consumer) const {
+    const HeapFile *file = scannedFile();
+    TransactionId scanTid = tid ? *tid : TransactionId();
+    int numPages = file->getNumPages();
+    int numMorsels = (numPages + morselPages - 1) / morselPages;
+
+    std::atomic<int> nextMorsel{0};
+    std::atomic<bool> failed{false};
+    std::mutex errorLatch;
+    std::exception_ptr error;
+
+    auto work = [&](int worker) {
+        try {
+            std::unique_ptr<ScanRing> ring = Database::getBufferPool().createScanRing(numPages);
+            for (int m = nextMorsel.fetch_add(1); m < numMorsels && !failed; m = nextMorsel.fetch_add(1)) {
+                int first = m * morselPages;
+                scanPages(file, scanTid, first, std::min(first + morselPages, numPages), ring.get(),
+                          [&](const Tuple &tuple) { consumer(worker, tuple); });
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorLatch);
+            if (!error) {
+                error = std::current_exception();
+            }
+            failed = true;
+        }
+    };
+
+    // The calling thread works as worker 0
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < workersFor(numMorsels); worker++) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ParallelSeqScan::runOrdered(const std::function<void(const Tuple &tuple)> &consumer) const {
+    const HeapFile *file = scannedFile();
+    TransactionId scanTid = tid ? *tid : TransactionId();
+    int numPages = file->getNumPages();
+    int numMorsels = (numPages + morselPages - 1) / morselPages;
+    int workers = workersFor(numMorsels);
+
+    // Morsel m is read into results[m % window]; workers never get more than
+    // window morsels ahead of the one being consumed
+    int window = 2 * workers;
+    std::vector<std::vector<Tuple>> results(window);
+    std::vector<bool> ready(window, false);
+    std::mutex latch;               // Protects everything below
+    std::condition_variable changed; // A morsel was read or consumed, or the scan stopped
+    int claimed = 0;
+    int delivered = 0;
+    bool stop = false;
+    std::exception_ptr error;
+
+    auto fail = [&]() {
+        std::lock_guard<std::mutex> lock(latch);
+        if (!error) {
+            error = std::current_exception();
+        }
+        stop = true;
+        changed.notify_all();
+    };
+
+    auto work = [&]() {
+        try {
+            std::unique_ptr<ScanRing> ring = Database::getBufferPool().createScanRing(numPages);
+            while (true) {
+                int m;
+                {
+                    std::unique_lock<std::mutex> lock(latch);
+                    changed.wait(lock, [&] { return stop || claimed >= numMorsels || claimed < delivered + window; });
+                    if (stop || claimed >= numMorsels) {
+                        return;
+                    }
+                    m = claimed++;
+                }
+                // Copy the tuples, so the pages are unpinned before the morsel is consumed
+                std::vector<Tuple> tuples;
+                int first = m * morselPages;
+                scanPages(file, scanTid, first, std::min(first + morselPages, numPages), ring.get(),
+                          [&](const Tuple &tuple) { tuples.push_back(tuple); });
+                {
+                    std::lock_guard<std::mutex> lock(latch);
+                    results[m % window] = std::move(tuples);
+                    ready[m % window] = true;
+                }
+                changed.notify_all();
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < workers; worker++) {
+        threads.emplace_back(work);
+    }
+    try {
+        for (int m = 0; m < numMorsels; m++) {
+            std::vector<Tuple> tuples;
+            {
+                std::unique_lock<std::mutex> lock(latch);
+                changed.wait(lock, [&] { return stop || ready[m % window]; });
+                if (!ready[m % window]) {
+                    break;
+                }
+                tuples = std::move(results[m % window]);
+                ready[m % window] = false;
+                delivered = m + 1;
+            }
+            changed.notify_all();
+            for (const Tuple &tuple : tuples) {
+                consumer(tuple);
+            }
+        }
+    } catch (...) {
+        fail();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
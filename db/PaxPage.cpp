@@ -0,0 +1,13 @@
+#include <db/PaxPage.h>
+
+using namespace db;
+
+PaxPage::PaxPage(const HeapPageId &id, uint8_t *data, bool inPlace) : HeapPage(id, data, inPlace, true) {
+}
+
+const uint8_t *PaxPage::getColumn(int col) const {
+    if (col < 0 || col >= static_cast<int>(layout.size())) {
+        throw std::out_of_range("PaxPage: field index out of range.");
+    }
+    return fieldAt(0, col);
+}
@@ -0,0 +1,88 @@
+/**
+ * Hit-ratio comparison of the BufferPool replacement policies on a mixed
+ * workload: point lookups on a small hot set of pages, interrupted by full
+ * sequential scans of a table much larger than the pool. A scan-resistant
+ * policy keeps the hot set cached across the scans.
+ *
+ * Usage: policy_bench [file] [table pages] [pool pages] [hot pages] [lookups per scan] [scans]
+ */
+#include <db/Database.h>
+#include <db/HeapFile.h>
+#include <db/HeapPageId.h>
+#include <db/Utility.h>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace db;
+
+/** Writes a table of numPages empty pages. */
+static void createTable(const char *fname, int numPages) {
+    FILE *file = fopen(fname, "wb");
+    if (file == nullptr) {
+        perror(fname);
+        exit(1);
+    }
+    std::vector<uint8_t> page(Database::getBufferPool().getPageSize(), 0);
+    for (int i = 0; i < numPages; i++) {
+        fwrite(page.data(), 1, page.size(), file);
+    }
+    fclose(file);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fname = argc > 1 ? argv[1] : "policy_bench.dat";
+    int numPages = argc > 2 ? atoi(argv[2]) : 4096;
+    int poolPages = argc > 3 ? atoi(argv[3]) : 256;
+    int hotPages = argc > 4 ? atoi(argv[4]) : 192;
+    int lookupsPerScan = argc > 5 ? atoi(argv[5]) : 1000;
+    int numScans = argc > 6 ? atoi(argv[6]) : 20;
+
+    createTable(fname, numPages);
+    Database::reset();
+    // The Catalog does not own its files; this one outlives the Database::reset below
+    auto file = std::make_unique<HeapFile>(fname, Utility::getTupleDesc(2));
+    Database::getCatalog().addTable(file.get(), "bench");
+    int tableId = file->getId();
+
+    const std::vector<std::pair<const char *, ReplacementPolicyType>> policies = {
+            {"LRU", ReplacementPolicyType::LRU},
+            {"CLOCK", ReplacementPolicyType::CLOCK},
+            {"2Q", ReplacementPolicyType::TWO_Q},
+            {"LRU-K", ReplacementPolicyType::LRU_K},
+    };
+
+    printf("%d pages, %d pool pages, %d hot pages, %d lookups between %d scans\n", numPages, poolPages, hotPages,
+           lookupsPerScan, numScans);
+    printf("%8s %16s %16s\n", "policy", "lookup hit ratio", "total hit ratio");
+    for (const auto &[name, type] : policies) {
+        // One shard, so the whole pool follows a single instance of the policy
+        BufferPool pool(poolPages, type, 1);
+        pool.setPrefetchDepth(0);
+        TransactionId tid;
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> hotPage(0, hotPages - 1);
+
+        size_t lookups = 0;
+        size_t lookupHits = 0;
+        for (int scan = 0; scan < numScans; scan++) {
+            for (int i = 0; i < lookupsPerScan; i++) {
+                size_t hits = pool.getHitCount();
+                PageGuard guard = pool.fetchPage(tid, HeapPageId(tableId, hotPage(random)));
+                lookups++;
+                lookupHits += pool.getHitCount() - hits;
+            }
+            for (int pageNo = 0; pageNo < numPages; pageNo++) {
+                PageGuard guard = pool.fetchPage(tid, HeapPageId(tableId, pageNo));
+            }
+        }
+        printf("%8s %16.3f %16.3f\n", name, static_cast<double>(lookupHits) / static_cast<double>(lookups),
+               pool.getHitRatio());
+    }
+    Database::reset();
+    remove(fname);
+    return 0;
+}
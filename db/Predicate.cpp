@@ -0,0 +1,125 @@
+#include <db/Predicate.h>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+using namespace db;
+
+Predicate::Predicate(int field, Op op, int32_t constant)
+        : field(field), op(op), type(Types::INT_TYPE), intConstant(constant) {
+}
+
+Predicate::Predicate(int field, Op op, std::string constant)
+        : field(field), op(op), type(Types::STRING_TYPE), stringConstant(std::move(constant)) {
+}
+
+void Predicate::check(const TupleDesc &td) const {
+    if (field < 0 || field >= static_cast<int>(td.numFields())) {
+        throw std::invalid_argument("Predicate: field index out of range.");
+    }
+    if (td.getFieldType(field) != type) {
+        throw std::invalid_argument("Predicate: field and constant have different types.");
+    }
+}
+
+/** Calls f with the comparison of op, as a function object. */
+template<typename F>
+static void withComparison(Predicate::Op op, F &&f) {
+    switch (op) {
+        case Predicate::Op::EQUALS:
+            return f(std::equal_to<>());
+        case Predicate::Op::NOT_EQUALS:
+            return f(std::not_equal_to<>());
+        case Predicate::Op::LESS_THAN:
+            return f(std::less<>());
+        case Predicate::Op::LESS_THAN_OR_EQ:
+            return f(std::less_equal<>());
+        case Predicate::Op::GREATER_THAN:
+            return f(std::greater<>());
+        case Predicate::Op::GREATER_THAN_OR_EQ:
+            return f(std::greater_equal<>());
+    }
+}
+
+/**
+ * Keeps positions[i] if values[i] satisfies cmp with constant. The kept
+ * position is always written and the output only advances on a match, so the
+ * loop has no data-dependent branch.
+ * @return the number of positions kept
+ */
+template<typename T, typename P, typename Cmp>
+static size_t compactDense(const T *values, const T &constant, P *positions, size_t count, Cmp cmp) {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        positions[kept] = positions[i];
+        kept += cmp(values[i], constant) ? 1 : 0;
+    }
+    return kept;
+}
+
+/** Same as compactDense, for values indexed by the positions themselves. */
+template<typename T, typename P, typename Cmp>
+static size_t compactSelected(const T *values, const T &constant, P *positions, size_t count, Cmp cmp) {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        P position = positions[i];
+        positions[kept] = position;
+        kept += cmp(values[position], constant) ? 1 : 0;
+    }
+    return kept;
+}
+
+bool Predicate::matches(const Tuple &t) const {
+    bool result = false;
+    withComparison(op, [&](auto cmp) {
+        if (type == Types::INT_TYPE) {
+            result = cmp(t.getInt(field), intConstant);
+        } else {
+            result = cmp(t.getString(field), std::string_view(stringConstant));
+        }
+    });
+    return result;
+}
+
+void Predicate::filter(const TuplePage &page, std::vector<int> &slots) const {
+    if (slots.empty()) {
+        return;
+    }
+    // Scratch space for the values of the field, reused across pages
+    thread_local std::vector<int32_t> ints;
+    thread_local std::vector<std::string_view> strings;
+    size_t kept = 0;
+    if (type == Types::INT_TYPE) {
+        ints.resize(slots.size());
+        page.readIntColumn(field, slots.data(), slots.size(), ints.data());
+        withComparison(op, [&](auto cmp) {
+            kept = compactDense(ints.data(), intConstant, slots.data(), slots.size(), cmp);
+        });
+    } else {
+        strings.resize(slots.size());
+        page.readStringColumn(field, slots.data(), slots.size(), strings.data());
+        std::string_view constant(stringConstant);
+        withComparison(op, [&](auto cmp) {
+            kept = compactDense(strings.data(), constant, slots.data(), slots.size(), cmp);
+        });
+    }
+    slots.resize(kept);
+}
+
+void Predicate::filter(TupleBatch &batch) const {
+    std::vector<uint32_t> &selection = batch.getSelection();
+    size_t kept = 0;
+    if (type == Types::INT_TYPE) {
+        const int32_t *values = batch.getIntColumn(field);
+        withComparison(op, [&](auto cmp) {
+            kept = compactSelected(values, intConstant, selection.data(), selection.size(), cmp);
+        });
+    } else {
+        const std::string_view *values = batch.getStringColumn(field);
+        std::string_view constant(stringConstant);
+        withComparison(op, [&](auto cmp) {
+            kept = compactSelected(values, constant, selection.data(), selection.size(), cmp);
+        });
+    }
+    selection.resize(kept);
+}
@@ -0,0 +1,20 @@
+#include <db/Projection.h>
+#include <stdexcept>
+
+using namespace db;
+
+Projection::Projection(const TupleDesc &table, std::vector<int> columns) : columns(std::move(columns)) {
+    if (this->columns.empty()) {
+        throw std::invalid_argument("Projection: no columns.");
+    }
+    std::vector<Types::Type> types;
+    std::vector<std::string> names;
+    for (int col : this->columns) {
+        if (col < 0 || col >= static_cast<int>(table.numFields())) {
+            throw std::invalid_argument("Projection: field index out of range.");
+        }
+        types.push_back(table.getFieldType(col));
+        names.push_back(table.getFieldName(col));
+    }
+    td = std::make_shared<const TupleDesc>(types, names);
+}
@@ -0,0 +1,93 @@
+#include <db/ReadAhead.h>
+#include <db/BufferPool.h>
+#include <algorithm>
+
+using namespace db;
+
+ReadAhead::ReadAhead(BufferPool &pool, int numThreads, int depth) : pool(pool), numThreads(numThreads), depth(depth) {
+}
+
+ReadAhead::~ReadAhead() {
+    {
+        std::lock_guard<std::mutex> guard(latch);
+        stopping = true;
+        queue.clear();
+        queued.clear();
+    }
+    wakeup.notify_all();
+    for (auto &t : workers) {
+        t.join();
+    }
+}
+
+void ReadAhead::setDepth(int newDepth) {
+    depth = std::max(0, newDepth);
+}
+
+void ReadAhead::onAccess(const PageKey &key, int numPages) {
+    int window = depth;
+    if (window == 0 || numThreads == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(latch);
+
+    Stream &stream = streams[key.tableId];
+    if (key.pageNo == stream.lastPage + 1) {
+        stream.runLength++;
+    } else {
+        // Random access or a new scan: start over
+        stream.runLength = 1;
+        stream.prefetchedTo = key.pageNo;
+    }
+    stream.lastPage = key.pageNo;
+    if (stream.runLength < SEQUENTIAL_THRESHOLD) {
+        return;
+    }
+
+    // Keep the window [page + 1, page + depth] queued
+    int first = std::max(stream.prefetchedTo, key.pageNo) + 1;
+    int last = std::min(key.pageNo + window, numPages - 1);
+    if (first > last) {
+        return;
+    }
+    for (int page = first; page <= last; page++) {
+        PageKey next(key.tableId, page);
+        if (queued.insert(next).second) {
+            queue.push_back(next);
+        }
+    }
+    stream.prefetchedTo = last;
+
+    if (workers.empty()) {
+        for (int i = 0; i < numThreads; i++) {
+            workers.emplace_back(&ReadAhead::worker, this);
+        }
+    }
+    guard.unlock();
+    wakeup.notify_all();
+}
+
+void ReadAhead::worker() {
+    std::unique_lock<std::mutex> guard(latch);
+    while (true) {
+        wakeup.wait(guard, [this] { return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+        // Take the run of consecutive pages at the front of the queue
+        PageKey first = queue.front();
+        int count = 0;
+        while (!queue.empty() && count < MAX_BATCH && queue.front().tableId == first.tableId &&
+               queue.front().pageNo == first.pageNo + count) {
+            queue.pop_front();
+            count++;
+        }
+
+        guard.unlock();
+        pool.prefetchPages(first.tableId, first.pageNo, count);
+        guard.lock();
+        for (int i = 0; i < count; i++) {
+            queued.erase(PageKey(first.tableId, first.pageNo + i));
+        }
+    }
+}
@@ -7,19 +7,14 @@ using namespace db;
 // RecordId
 //
 
-RecordId::RecordId(const PageId *pid, int tupleno): pid(pid), tupleno(tupleno){
+RecordId::RecordId(const PageId *pid, int tupleno) : RecordId(*pid, tupleno) {
 }
 
-bool RecordId::operator==(const RecordId &other) const {
-    return *pid == *(other.pid) && tupleno == other.tupleno;
-}
-
-const PageId *RecordId::getPageId() const {
-    return pid;
-}
-
-int RecordId::getTupleno() const {
-    return tupleno;
+RecordId::RecordId(int tableId, int pageNo, int tupleno) : tableId(tableId) {
+    if (pageNo < 0 || tupleno < 0 || tupleno >= (1 << SLOT_BITS)) {
+        throw std::out_of_range("RecordId: page or tuple number out of range.");
+    }
+    location = static_cast<uint64_t>(pageNo) << SLOT_BITS | static_cast<uint64_t>(tupleno);
 }
 
 //
@@ -27,5 +22,13 @@ int RecordId::getTupleno() const {
 //
 
 std::size_t std::hash<RecordId>::operator()(const RecordId &r) const {
-    return std::hash<int>()(r.getPageId()->getTableId()) ^ std::hash<int>()(r.getTupleno());
+    // Spread the table over all 64 bits, then mix (the splitmix64 finalizer) so that
+    // RecordIds of neighbouring slots and pages land in unrelated buckets
+    uint64_t x = r.getLocation() + 0x9e3779b97f4a7c15ULL * static_cast<uint32_t>(r.getTableId());
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<std::size_t>(x);
 }
@@ -0,0 +1,276 @@
+#include <db/ReplacementPolicy.h>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace db;
+
+std::unique_ptr<ReplacementPolicy> ReplacementPolicy::create(ReplacementPolicyType type, int numFrames) {
+    switch (type) {
+        case ReplacementPolicyType::LRU:
+            return std::make_unique<LruPolicy>(numFrames);
+        case ReplacementPolicyType::CLOCK:
+            return std::make_unique<ClockPolicy>(numFrames);
+        case ReplacementPolicyType::TWO_Q:
+            return std::make_unique<TwoQPolicy>(numFrames);
+        case ReplacementPolicyType::LRU_K:
+            return std::make_unique<LruKPolicy>(numFrames);
+        default:
+            throw std::invalid_argument(std::string(__PRETTY_FUNCTION__) + " unexpected policy");
+    }
+}
+
+//
+// FrameList
+//
+
+void FrameList::pushFront(int frame) {
+    prev[frame] = -1;
+    next[frame] = head;
+    if (head != -1) prev[head] = frame; else tail = frame;
+    head = frame;
+    count++;
+}
+
+void FrameList::unlink(int frame) {
+    if (prev[frame] != -1) next[prev[frame]] = next[frame]; else head = next[frame];
+    if (next[frame] != -1) prev[next[frame]] = prev[frame]; else tail = prev[frame];
+    prev[frame] = next[frame] = -1;
+    count--;
+}
+
+//
+// LruPolicy
+//
+
+void LruPolicy::recordInsert(int frame, const PageKey &) {
+    present[frame] = true;
+    if (evictable[frame]) {
+        list.pushFront(frame);
+    }
+}
+
+void LruPolicy::recordAccess(int frame) {
+    // A pinned frame goes back to the front when it is released
+    if (present[frame] && evictable[frame]) {
+        list.moveToFront(frame);
+    }
+}
+
+void LruPolicy::remove(int frame) {
+    if (present[frame] && evictable[frame]) {
+        list.unlink(frame);
+    }
+    present[frame] = false;
+}
+
+int LruPolicy::selectVictim() {
+    int victim = list.back();
+    if (victim != -1) {
+        list.unlink(victim);
+        present[victim] = false;
+    }
+    return victim;
+}
+
+void LruPolicy::setEvictable(int frame, bool value) {
+    if (evictable[frame] == value) {
+        return;
+    }
+    evictable[frame] = value;
+    if (present[frame]) {
+        if (value) {
+            list.pushFront(frame);
+        } else {
+            list.unlink(frame);
+        }
+    }
+}
+
+//
+// ClockPolicy
+//
+
+void ClockPolicy::recordInsert(int frame, const PageKey &) {
+    present[frame] = true;
+    referenced[frame] = true;
+}
+
+int ClockPolicy::selectVictim() {
+    int n = static_cast<int>(present.size());
+    // Two sweeps are enough: the first one clears every reference bit
+    for (int i = 0; i < 2 * n; i++) {
+        int frame = hand;
+        hand = (hand + 1) % n;
+        if (!present[frame] || !evictable[frame]) continue;
+        if (referenced[frame]) {
+            referenced[frame] = false;
+            continue;
+        }
+        present[frame] = false;
+        return frame;
+    }
+    return -1;
+}
+
+//
+// TwoQPolicy
+//
+
+TwoQPolicy::TwoQPolicy(int numFrames)
+        : ReplacementPolicy(numFrames), a1in(numFrames), am(numFrames), queueOf(numFrames, NONE), keys(numFrames, PageKey(-1, -1)),
+          kin(std::max(1, numFrames / 4)), kout(std::max(1, numFrames / 2)) {
+}
+
+void TwoQPolicy::recordInsert(int frame, const PageKey &key) {
+    keys[frame] = key;
+    auto ghost = a1outIndex.find(key);
+    if (ghost != a1outIndex.end()) {
+        // Seen again after leaving A1in: the page is hot
+        a1out.erase(ghost->second);
+        a1outIndex.erase(ghost);
+        queueOf[frame] = AM;
+    } else {
+        queueOf[frame] = A1IN;
+        a1inSize++;
+    }
+    if (evictable[frame]) {
+        listOf(frame).pushFront(frame);
+    }
+}
+
+void TwoQPolicy::recordAccess(int frame) {
+    // Hits in A1in are treated as correlated references and do not promote
+    if (queueOf[frame] == AM && evictable[frame]) {
+        am.moveToFront(frame);
+    }
+}
+
+void TwoQPolicy::remove(int frame) {
+    if (queueOf[frame] == NONE) {
+        return;
+    }
+    if (evictable[frame]) {
+        listOf(frame).unlink(frame);
+    }
+    if (queueOf[frame] == A1IN) {
+        a1inSize--;
+    }
+    queueOf[frame] = NONE;
+}
+
+void TwoQPolicy::setEvictable(int frame, bool value) {
+    if (evictable[frame] == value) {
+        return;
+    }
+    evictable[frame] = value;
+    if (queueOf[frame] != NONE) {
+        if (value) {
+            listOf(frame).pushFront(frame);
+        } else {
+            listOf(frame).unlink(frame);
+        }
+    }
+}
+
+int TwoQPolicy::evictFrom(FrameList &queue) {
+    int victim = queue.back();
+    if (victim != -1) {
+        queue.unlink(victim);
+        if (queueOf[victim] == A1IN) {
+            a1inSize--;
+        }
+        queueOf[victim] = NONE;
+    }
+    return victim;
+}
+
+int TwoQPolicy::selectVictim() {
+    int victim = -1;
+    if (a1inSize <= kin) {
+        victim = evictFrom(am);
+    }
+    if (victim != -1) {
+        return victim;
+    }
+    victim = evictFrom(a1in);
+    if (victim == -1) {
+        // Everything in A1in is pinned
+        return evictFrom(am);
+    }
+    // Remember the page so a re-reference promotes it to Am
+    a1out.push_front(keys[victim]);
+    a1outIndex[keys[victim]] = a1out.begin();
+    if (a1out.size() > kout) {
+        a1outIndex.erase(a1out.back());
+        a1out.pop_back();
+    }
+    return victim;
+}
+
+//
+// LruKPolicy
+//
+
+LruKPolicy::LruKPolicy(int numFrames, int k) : ReplacementPolicy(numFrames), k(k), history(numFrames), present(numFrames, false) {
+    if (k < 1) {
+        throw std::invalid_argument("LRU-K requires k >= 1.");
+    }
+}
+
+LruKPolicy::Entry LruKPolicy::entryOf(int frame) const {
+    const auto &h = history[frame];
+    return {static_cast<int>(h.size()) == k, h.front(), frame};
+}
+
+void LruKPolicy::touch(int frame) {
+    auto &h = history[frame];
+    if (static_cast<int>(h.size()) == k) {
+        h.erase(h.begin());
+    }
+    h.push_back(now++);
+}
+
+void LruKPolicy::recordInsert(int frame, const PageKey &) {
+    history[frame].clear();
+    touch(frame);
+    present[frame] = true;
+    if (evictable[frame]) {
+        order.insert(entryOf(frame));
+    }
+}
+
+void LruKPolicy::recordAccess(int frame) {
+    if (!evictable[frame]) {
+        touch(frame);
+        return;
+    }
+    order.erase(entryOf(frame));
+    touch(frame);
+    order.insert(entryOf(frame));
+}
+
+void LruKPolicy::remove(int frame) {
+    if (present[frame]) {
+        if (evictable[frame]) {
+            order.erase(entryOf(frame));
+        }
+        present[frame] = false;
+    }
+}
+
+void LruKPolicy::setEvictable(int frame, bool value) {
+    if (present[frame] && evictable[frame] != value) {
+        if (value) order.insert(entryOf(frame)); else order.erase(entryOf(frame));
+    }
+    evictable[frame] = value;
+}
+
+int LruKPolicy::selectVictim() {
+    if (order.empty()) {
+        return -1;
+    }
+    int victim = std::get<2>(*order.begin());
+    order.erase(order.begin());
+    present[victim] = false;
+    return victim;
+}
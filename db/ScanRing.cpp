@@ -0,0 +1,88 @@
+#include <db/ScanRing.h>
+#include <db/Database.h>
+#include <db/HeapFile.h>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+using namespace db;
+
+ScanRing::ScanRing(int numSlots, size_t pageSize)
+        : arena(std::max(numSlots, 2), pageSize, false), slots(std::max(numSlots, 2)) {
+}
+
+ScanRing::~ScanRing() {
+    for (Slot &s : slots) {
+        // A PageGuard still holding the frame would unpin it after the ring is gone
+        assert(s.pinCount == 0 && "ScanRing destroyed while a frame is pinned");
+        delete s.page;
+    }
+}
+
+Page *ScanRing::pin(const PageId &pid, int window, int &slot, int &prefetched) {
+    PageKey key(pid);
+    prefetched = 0;
+    if (int cached = find(key); cached != -1) {
+        slots[cached].pinCount++;
+        slot = cached;
+        return slots[cached].page;
+    }
+
+    // Claim the oldest unpinned frames for pid and the pages after it that the
+    // ring does not hold yet, so the window is read with one batch
+    const auto *heapFile = dynamic_cast<const HeapFile *>(Database::getCatalog().getDatabaseFile(pid.getTableId()));
+    int lastPage = heapFile != nullptr ? heapFile->getNumPages() - 1 : pid.pageNumber();
+    window = std::max(1, std::min({window, static_cast<int>(slots.size()) / 2, lastPage - pid.pageNumber() + 1}));
+    std::vector<size_t> victims;
+    size_t victim = next;
+    for (size_t tried = 0; tried < slots.size() && static_cast<int>(victims.size()) < window; tried++) {
+        if (!victims.empty() && find(PageKey(key.tableId, key.pageNo + static_cast<int>(victims.size()))) != -1) {
+            break;
+        }
+        if (slots[victim].pinCount == 0) {
+            victims.push_back(victim);
+        }
+        victim = (victim + 1) % slots.size();
+    }
+    if (victims.empty()) {
+        throw std::runtime_error("ScanRing: all frames are pinned.");
+    }
+    std::vector<uint8_t *> frames;
+    for (size_t v : victims) {
+        Slot &s = slots[v];
+        delete s.page;
+        s.page = nullptr;
+        s.key = PageKey(-1, -1);
+        frames.push_back(arena.frame(static_cast<int>(v)));
+    }
+
+    std::vector<Page *> pages;
+    if (heapFile != nullptr && victims.size() > 1) {
+        pages = heapFile->readPages(pid.pageNumber(), static_cast<int>(victims.size()), frames);
+    } else {
+        DbFile *file = Database::getCatalog().getDatabaseFile(pid.getTableId());
+        pages.push_back(file->readPage(pid, frames[0]));
+    }
+    for (size_t i = 0; i < victims.size(); i++) {
+        slots[victims[i]].page = pages[i];
+        slots[victims[i]].key = PageKey(key.tableId, key.pageNo + static_cast<int>(i));
+    }
+    slots[victims[0]].pinCount = 1;
+    next = (victims.back() + 1) % slots.size();
+    slot = static_cast<int>(victims[0]);
+    prefetched = static_cast<int>(victims.size()) - 1;
+    return slots[victims[0]].page;
+}
+
+int ScanRing::find(const PageKey &key) const {
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].page != nullptr && slots[i].key == key) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void ScanRing::unpin(int slot) {
+    slots[slot].pinCount--;
+}
@@ -8,6 +8,29 @@ SeqScan::SeqScan(TransactionId *tid, int tableid, const std::string &tableAlias)
     this->tupleDesc = Database::getCatalog().getTupleDesc(tableid);
 }
 
+SeqScan::SeqScan(TransactionId *tid, int tableid, const std::string &tableAlias, std::vector<Predicate> predicates)
+        : SeqScan(tid, tableid, tableAlias) {
+    for (const Predicate &predicate : predicates) {
+        predicate.check(tupleDesc);
+    }
+    this->predicates = std::move(predicates);
+}
+
+SeqScan::SeqScan(TransactionId *tid, int tableid, const std::string &tableAlias, std::vector<Predicate> predicates,
+                 std::vector<int> columns)
+        : SeqScan(tid, tableid, tableAlias, std::move(predicates)) {
+    projection.emplace(tupleDesc, std::move(columns));
+    this->tupleDesc = *projection->getTupleDesc();
+}
+
+const std::vector<Predicate> &SeqScan::getPredicates() const {
+    return predicates;
+}
+
+const Projection *SeqScan::getProjection() const {
+    return projection ? &*projection : nullptr;
+}
+
 std::string SeqScan::getTableName() const {
     return Database::getCatalog().getTableName(tableid);
 }
@@ -20,6 +43,9 @@ void SeqScan::reset(int tabid, const std::string &tabAlias) {
     this->tableid = tabid;
     this->tableAlias = tabAlias;
     this->tupleDesc = Database::getCatalog().getTupleDesc(tableid);
+    // The predicates and the projection were made for the previous table
+    this->predicates.clear();
+    this->projection.reset();
 }
 
 const TupleDesc &SeqScan::getTupleDesc() const {
@@ -50,49 +76,35 @@ SeqScan::iterator SeqScan::end() const {
 // SeqScanIterator
 //
 
-SeqScanIterator::SeqScanIterator(const SeqScan *scan, bool isBegin) {
-    this->scan = scan;
-    this->isBegin = isBegin;
-    if (isBegin) {
-        currentPageIndex = 0; // Start with the first page
-        currentTupleIndex = 0;
-    } else {
-        currentPageIndex = -1; // Indicates the end of the scan
-        currentTupleIndex = -1;
+static const HeapFile *scannedFile(const SeqScan *scan) {
+    const auto *file = dynamic_cast<const HeapFile *>(Database::getCatalog().getDatabaseFile(scan->getTableId()));
+    if (file == nullptr) {
+        throw std::runtime_error("SeqScan: table is not a HeapFile.");
     }
+    return file;
+}
+
+SeqScanIterator::SeqScanIterator(const SeqScan *scan, bool isBegin)
+    : scan(scan),
+      fileIter(scannedFile(scan), isBegin ? 0 : scannedFile(scan)->getNumPages(),
+               scan->getTransactionId() ? *scan->getTransactionId() : TransactionId(), &scan->getPredicates(),
+               scan->getProjection()) {
 }
 
 bool SeqScanIterator::operator!=(const SeqScanIterator &other) const {
-    return currentPageIndex != other.currentPageIndex || currentTupleIndex != other.currentTupleIndex;
+    return fileIter != other.fileIter;
 }
 
 SeqScanIterator &SeqScanIterator::operator++() {
-    if (currentPageIndex >= 0) {
-        currentTupleIndex++;
-        if (currentTupleIndex >= scan->getNumFields()) {
-            // Move to the next page if we have scanned all tuples on the current page
-            currentTupleIndex = 0;
-            currentPageIndex++;
-            if (currentPageIndex >= scan->getNumFields()) {
-                // Reached the end of the scan
-                currentPageIndex = -1;
-            }
-        }
-    }
+    ++fileIter;
     return *this;
 }
 
 const Tuple &SeqScanIterator::operator*() const {
-    if (currentPageIndex >= 0) {
-        // Create a HeapPageId using the table ID and current page index
-        HeapPageId pageId(scan->getTableId(), currentPageIndex);
-
-        // Fetch and return the current tuple
-        Page *page = Database::getBufferPool().getPage(*scan->getTransactionId(), &pageId);
-        Tuple *tuple = reinterpret_cast<Tuple *>(page->getPageData());
-        return tuple[currentTupleIndex];
-    } else {
-        // Return an empty tuple to indicate the end of the scan
-        return Tuple();
-    }
+    // The tuple lives in a page pinned by fileIter, so it stays valid until the next ++
+    return *fileIter;
+}
+
+size_t SeqScanIterator::nextBatch(TupleBatch &batch) {
+    return fileIter.nextBatch(batch);
 }
@@ -9,6 +9,10 @@ Page *SkeletonFile::readPage(const PageId &pid) {
     throw std::runtime_error(std::string(__PRETTY_FUNCTION__) + " not implemented");
 }
 
+void SkeletonFile::writePage(Page *) const {
+    throw std::runtime_error(std::string(__PRETTY_FUNCTION__) + " not implemented");
+}
+
 SkeletonFileIterator SkeletonFile::begin() const {
     throw std::runtime_error(std::string(__PRETTY_FUNCTION__) + " not implemented");
 }
@@ -0,0 +1,289 @@
+#include <db/SlottedPage.h>
+#include <db/Database.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace db;
+
+/** The largest number of records of td that fit in a page, each with its directory entry. */
+static int maxSlots(const TupleDesc &td, size_t pageSize) {
+    size_t smallest = 0;
+    for (const auto &item: td) {
+        smallest += item.fieldType == Types::INT_TYPE ? sizeof(int) : sizeof(uint16_t);
+    }
+    // Header and directory entries are 4 bytes each
+    return static_cast<int>((pageSize - 4) / (4 + std::max<size_t>(smallest, 1)));
+}
+
+SlottedPage::SlottedPage(const HeapPageId &id, uint8_t *data, bool inPlace)
+        : TuplePage(maxSlots(Database::getCatalog().getTupleDesc(id.getTableId()), Database::getBufferPool().getPageSize())),
+          pid(id), td(Database::getCatalog().getSharedTupleDesc(id.getTableId())), ownsData(!inPlace),
+          pageSize(Database::getBufferPool().getPageSize()) {
+    if (pageSize > 65536) {
+        throw std::invalid_argument("SlottedPage: the page size does not fit 2-byte offsets.");
+    }
+    if (inPlace) {
+        this->data = data;
+    } else {
+        this->data = new uint8_t[pageSize];
+        memcpy(this->data, data, pageSize);
+    }
+    if (getNumSlots() > maxSlots(*td, pageSize) || HEADER_SIZE + getNumSlots() * SLOT_SIZE > dataStart()) {
+        if (ownsData) {
+            delete[] this->data;
+        }
+        throw std::runtime_error("SlottedPage: corrupt slot directory.");
+    }
+}
+
+SlottedPage::~SlottedPage() {
+    if (ownsData) {
+        delete[] data;
+    }
+}
+
+uint16_t SlottedPage::read16(size_t offset) const {
+    uint16_t value;
+    memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+void SlottedPage::write16(size_t offset, uint16_t value) {
+    memcpy(data + offset, &value, sizeof(value));
+}
+
+size_t SlottedPage::dataStart() const {
+    size_t start = read16(2);
+    return start == 0 ? pageSize : start;
+}
+
+PageId &SlottedPage::getId() {
+    return pid;
+}
+
+void *SlottedPage::getPageData() {
+    auto *pageData = new uint8_t[pageSize];
+    memcpy(pageData, data, pageSize);
+    return pageData;
+}
+
+void SlottedPage::markDirty(bool dirty, const TransactionId &tid) {
+    if (dirty) {
+        dirtier = tid;
+    } else {
+        dirtier.reset();
+    }
+}
+
+const TransactionId *SlottedPage::isDirty() const {
+    return dirtier ? &*dirtier : nullptr;
+}
+
+int SlottedPage::getNumSlots() const {
+    return read16(0);
+}
+
+int SlottedPage::getNumEmptySlots() const {
+    int count = 0;
+    for (int slot = 0; slot < getNumSlots(); slot++) {
+        if (recordOffset(slot) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool SlottedPage::isSlotUsed(int i) const {
+    return i >= 0 && i < getNumSlots() && recordOffset(i) != 0;
+}
+
+int SlottedPage::nextUsedSlot(int from) const {
+    int numSlots = getNumSlots();
+    for (int slot = std::max(from, 0); slot < numSlots; slot++) {
+        if (recordOffset(slot) != 0) {
+            return slot;
+        }
+    }
+    return numSlots;
+}
+
+size_t SlottedPage::getUsedSlots(std::vector<int> &slots) const {
+    slots.clear();
+    for (int slot = 0; slot < getNumSlots(); slot++) {
+        if (recordOffset(slot) != 0) {
+            slots.push_back(slot);
+        }
+    }
+    return slots.size();
+}
+
+const uint8_t *SlottedPage::fieldData(int slot, int col, Types::Type type) const {
+    if (!isSlotUsed(slot) || col < 0 || col >= static_cast<int>(td->numFields())) {
+        throw std::out_of_range("SlottedPage: slot or field index out of range.");
+    }
+    if (td->getFieldType(col) != type) {
+        throw std::invalid_argument("SlottedPage: field has a different type.");
+    }
+    // Records are variable length: skip the fields before col
+    const uint8_t *field = data + recordOffset(slot);
+    for (int i = 0; i < col; i++) {
+        if (td->getFieldType(i) == Types::INT_TYPE) {
+            field += sizeof(int);
+        } else {
+            uint16_t len;
+            memcpy(&len, field, sizeof(len));
+            field += sizeof(len) + len;
+        }
+    }
+    return field;
+}
+
+int SlottedPage::getInt(int slot, int col) const {
+    int value;
+    memcpy(&value, fieldData(slot, col, Types::INT_TYPE), sizeof(int));
+    return value;
+}
+
+std::string_view SlottedPage::getStringView(int slot, int col) const {
+    const uint8_t *field = fieldData(slot, col, Types::STRING_TYPE);
+    uint16_t len;
+    memcpy(&len, field, sizeof(len));
+    return {reinterpret_cast<const char *>(field + sizeof(len)), len};
+}
+
+Tuple *SlottedPage::readTuple(int slot) const {
+    Tuple *t = newTuple(td, RecordId(pid, slot));
+    for (size_t i = 0; i < td->numFields(); i++) {
+        int col = static_cast<int>(i);
+        if (td->getFieldType(i) == Types::INT_TYPE) {
+            t->setInt(col, getInt(slot, col));
+        } else {
+            t->setString(col, getStringView(slot, col));
+        }
+    }
+    return t;
+}
+
+size_t SlottedPage::recordSize(const Tuple &t) const {
+    if (t.getSharedTupleDesc() != td && t.getTupleDesc().numFields() != td->numFields()) {
+        throw std::invalid_argument("SlottedPage: tuple does not match the page schema.");
+    }
+    size_t size = 0;
+    for (size_t i = 0; i < td->numFields(); i++) {
+        const Value &value = t.getValue(static_cast<int>(i));
+        if (value.getType() != td->getFieldType(i)) {
+            throw std::invalid_argument("SlottedPage: tuple does not match the page schema.");
+        }
+        if (value.getType() == Types::INT_TYPE) {
+            size += sizeof(int);
+        } else {
+            size += sizeof(uint16_t) + value.getStringLength();
+        }
+    }
+    return size;
+}
+
+size_t SlottedPage::getFreeSpace() const {
+    size_t used = HEADER_SIZE + getNumSlots() * SLOT_SIZE;
+    for (int slot = 0; slot < getNumSlots(); slot++) {
+        used += recordLength(slot);
+    }
+    return pageSize - used;
+}
+
+int SlottedPage::insertTuple(const Tuple &t) {
+    size_t size = recordSize(t);
+    int numSlots = getNumSlots();
+
+    // Reuse an empty directory entry before growing the directory
+    int slot = -1;
+    for (int i = 0; i < numSlots && slot == -1; i++) {
+        if (recordOffset(i) == 0) {
+            slot = i;
+        }
+    }
+    bool newEntry = slot == -1;
+    if (newEntry) {
+        slot = numSlots;
+        if (slot >= maxSlots(*td, pageSize)) {
+            return -1;
+        }
+    }
+    size_t need = size + (newEntry ? SLOT_SIZE : 0);
+    if (need > getFreeSpace()) {
+        return -1;
+    }
+    size_t directoryEnd = HEADER_SIZE + numSlots * SLOT_SIZE;
+    if (dataStart() - directoryEnd < need) {
+        compact();
+    }
+
+    // Write the record just below the lowest one
+    size_t offset = dataStart() - size;
+    uint8_t *record = data + offset;
+    for (size_t i = 0; i < td->numFields(); i++) {
+        int col = static_cast<int>(i);
+        if (td->getFieldType(i) == Types::INT_TYPE) {
+            int value = t.getInt(col);
+            memcpy(record, &value, sizeof(int));
+            record += sizeof(int);
+        } else {
+            std::string_view value = t.getString(col);
+            auto len = static_cast<uint16_t>(value.size());
+            memcpy(record, &len, sizeof(len));
+            memcpy(record + sizeof(len), value.data(), len);
+            record += sizeof(len) + len;
+        }
+    }
+
+    write16(2, static_cast<uint16_t>(offset));
+    write16(HEADER_SIZE + slot * SLOT_SIZE, static_cast<uint16_t>(offset));
+    write16(HEADER_SIZE + slot * SLOT_SIZE + 2, static_cast<uint16_t>(size));
+    if (newEntry) {
+        write16(0, static_cast<uint16_t>(numSlots + 1));
+    }
+    return slot;
+}
+
+void SlottedPage::deleteTuple(int slot) {
+    if (!isSlotUsed(slot)) {
+        throw std::out_of_range("SlottedPage: slot is not used.");
+    }
+    forgetTuple(slot);
+    size_t offset = recordOffset(slot);
+    write16(HEADER_SIZE + slot * SLOT_SIZE, 0);
+    write16(HEADER_SIZE + slot * SLOT_SIZE + 2, 0);
+    if (offset == dataStart()) {
+        // The lowest record: its space joins the free space without compaction
+        size_t start = pageSize;
+        for (int i = 0; i < getNumSlots(); i++) {
+            if (recordOffset(i) != 0) {
+                start = std::min(start, recordOffset(i));
+            }
+        }
+        write16(2, static_cast<uint16_t>(start == pageSize ? 0 : start));
+    }
+
+    int numSlots = getNumSlots();
+    while (numSlots > 0 && recordOffset(numSlots - 1) == 0) {
+        numSlots--;
+    }
+    write16(0, static_cast<uint16_t>(numSlots));
+}
+
+void SlottedPage::compact() {
+    std::vector<int> slots;
+    getUsedSlots(slots);
+    // Move the highest records first, so a record never overwrites one that has not moved yet
+    std::sort(slots.begin(), slots.end(), [this](int a, int b) { return recordOffset(a) > recordOffset(b); });
+
+    size_t end = pageSize;
+    for (int slot : slots) {
+        size_t length = recordLength(slot);
+        end -= length;
+        memmove(data + end, data + recordOffset(slot), length);
+        write16(HEADER_SIZE + slot * SLOT_SIZE, static_cast<uint16_t>(end));
+    }
+    write16(2, static_cast<uint16_t>(end == pageSize ? 0 : end));
+}
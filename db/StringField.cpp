@@ -1,4 +1,5 @@
 #include <db/StringField.h>
+#include <algorithm>
 
 using namespace db;
 
@@ -26,14 +27,17 @@ Types::Type StringField::getType() const {
 void StringField::serialize(void *data) const {
     auto *ptr = (uint8_t *) data;
     memcpy(ptr, &len, sizeof(int));
-    memcpy(ptr + sizeof(int), &value, sizeof(int));
+    memcpy(ptr + sizeof(int), value, len);
+    memset(ptr + sizeof(int) + len, 0, Types::STRING_LEN - len);
 }
 
 Field *StringField::parse(void *data) {
     auto *ptr = (uint8_t *) data;
     int len;
     memcpy(&len, ptr, sizeof(int));
+    len = std::max(0, std::min(len, static_cast<int>(Types::STRING_LEN) - 1));
     char value[Types::STRING_LEN];
     memcpy(value, ptr + sizeof(int), len);
+    value[len] = '\0';
     return new StringField(value);
 }
@@ -1,5 +1,10 @@
 #include <db/Tuple.h>
+#include <db/IntField.h>
+#include <db/StringField.h>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <utility>
 
 using namespace db;
 
@@ -7,51 +12,259 @@ using namespace db;
 // Tuple
 //
 
-Tuple::Tuple(const TupleDesc &td, RecordId *rid): tupleDesc(td), recordId(rid) { //recordId yet to be defined
-    fields.resize(td.numFields(), nullptr);
+Tuple::Tuple(const TupleDesc &td, const RecordId *rid): Tuple(std::make_shared<const TupleDesc>(td), rid) {
+}
+
+Tuple::Tuple(std::shared_ptr<const TupleDesc> td, const RecordId *rid): Tuple(std::move(td), RecordId()) {
+    setRecordId(rid);
+}
+
+Tuple::Tuple(std::shared_ptr<const TupleDesc> td, const RecordId &rid, std::pmr::memory_resource *memory)
+        : values(memory), strings(memory), tupleDesc(std::move(td)), recordId(rid) {
+    values.reserve(tupleDesc->numFields());
+    for (size_t i = 0; i < tupleDesc->numFields(); i++) {
+        values.push_back(tupleDesc->getFieldType(i) == Types::STRING_TYPE ? Value::ofString(0, 0) : Value::ofInt(0));
+    }
+}
+
+Tuple::Tuple(const Tuple &other)
+        : values(other.values), strings(other.strings), tupleDesc(other.tupleDesc), recordId(other.recordId) {
+}
+
+Tuple &Tuple::operator=(const Tuple &other) {
+    if (this != &other) {
+        dropFields();
+        values = other.values;
+        strings = other.strings;
+        tupleDesc = other.tupleDesc;
+        recordId = other.recordId;
+    }
+    return *this;
+}
+
+Tuple::Tuple(Tuple &&other) noexcept
+        : values(std::move(other.values)), strings(std::move(other.strings)), tupleDesc(std::move(other.tupleDesc)),
+          recordId(std::exchange(other.recordId, std::nullopt)),
+          fields(other.fields.exchange(nullptr, std::memory_order_acq_rel)) {
+}
+
+Tuple &Tuple::operator=(Tuple &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (values.get_allocator() == other.values.get_allocator()) {
+        // The storage and the Fields live in the same resource, so they move without allocating
+        dropFields();
+        fields.store(other.fields.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+        values = std::move(other.values);
+        strings = std::move(other.strings);
+    } else {
+        // Copy into the resource of this tuple first, so a bad_alloc leaves both tuples unchanged
+        std::pmr::vector<Value> copiedValues(other.values, values.get_allocator());
+        std::pmr::string copiedStrings(other.strings, strings.get_allocator());
+        dropFields();
+        values.swap(copiedValues);
+        strings.swap(copiedStrings);
+    }
+    tupleDesc = std::move(other.tupleDesc);
+    recordId = std::exchange(other.recordId, std::nullopt);
+    return *this;
+}
+
+Tuple::~Tuple() {
+    dropFields();
+}
+
+/** Builds a Field of type F in memory. */
+template<typename F, typename Arg>
+static const Field *newField(std::pmr::memory_resource *memory, Arg arg) {
+    return new (memory->allocate(sizeof(F), alignof(F))) F(arg);
+}
+
+static void deleteField(std::pmr::memory_resource *memory, const Field *field) {
+    if (field == nullptr) {
+        return;
+    }
+    bool isInt = field->getType() == Types::INT_TYPE;
+    field->~Field();
+    void *p = const_cast<Field *>(field);
+    if (isInt) {
+        memory->deallocate(p, sizeof(IntField), alignof(IntField));
+    } else {
+        memory->deallocate(p, sizeof(StringField), alignof(StringField));
+    }
+}
+
+void Tuple::dropFields() {
+    std::atomic<const Field *> *built = fields.exchange(nullptr, std::memory_order_acq_rel);
+    if (built == nullptr) {
+        return;
+    }
+    std::pmr::memory_resource *memory = values.get_allocator().resource();
+    for (size_t i = 0; i < values.size(); i++) {
+        deleteField(memory, built[i].load(std::memory_order_relaxed));
+    }
+    std::pmr::polymorphic_allocator<std::atomic<const Field *>>(memory).deallocate(built, values.size());
 }
 
 const TupleDesc &Tuple::getTupleDesc() const {
-    return tupleDesc;
+    static const TupleDesc empty;
+    return tupleDesc ? *tupleDesc : empty;
 }
 
 const RecordId *Tuple::getRecordId() const {
-    return recordId; //recordId yet to be defined
+    return recordId ? &*recordId : nullptr;
 }
 
 void Tuple::setRecordId(const RecordId *id) {
-    recordId = id; //recordId yet to be defined
+    if (id != nullptr) {
+        recordId = *id;
+    } else {
+        recordId.reset();
+    }
 }
 
-const Field &Tuple::getField(int i) const {
-    if (i < 0 || i >= fields.size()) {
+void Tuple::checkIndex(int i) const {
+    if (i < 0 || i >= static_cast<int>(values.size())) {
         throw std::out_of_range("Field index out of range.");
     }
-    return *fields[i];
+}
+
+void Tuple::forgetField(int i) {
+    std::atomic<const Field *> *built = fields.load(std::memory_order_acquire);
+    if (built != nullptr) {
+        deleteField(values.get_allocator().resource(), built[i].exchange(nullptr, std::memory_order_acq_rel));
+    }
+}
+
+const Field &Tuple::getField(int i) const {
+    checkIndex(i);
+    std::pmr::memory_resource *memory = values.get_allocator().resource();
+    std::atomic<const Field *> *built = fields.load(std::memory_order_acquire);
+    if (built == nullptr) {
+        std::pmr::polymorphic_allocator<std::atomic<const Field *>> allocator(memory);
+        std::atomic<const Field *> *allocated = allocator.allocate(values.size());
+        for (size_t j = 0; j < values.size(); j++) {
+            new (&allocated[j]) std::atomic<const Field *>(nullptr);
+        }
+        if (fields.compare_exchange_strong(built, allocated, std::memory_order_acq_rel)) {
+            built = allocated;
+        } else {
+            allocator.deallocate(allocated, values.size());
+        }
+    }
+
+    const Field *field = built[i].load(std::memory_order_acquire);
+    if (field == nullptr) {
+        // Another thread may build the same Field at the same time; the first one wins
+        const Field *created;
+        if (values[i].getType() == Types::INT_TYPE) {
+            created = newField<IntField>(memory, values[i].getInt());
+        } else {
+            created = newField<StringField>(memory, std::string(getString(i)).c_str());
+        }
+        if (built[i].compare_exchange_strong(field, created, std::memory_order_acq_rel)) {
+            field = created;
+        } else {
+            deleteField(memory, created);
+        }
+    }
+    return *field;
 }
 
 void Tuple::setField(int i, const Field *f) {
-    if (i < 0 || i >= fields.size()) {
-        throw std::out_of_range("Field index out of range.");
+    checkIndex(i);
+    if (f->getType() == Types::INT_TYPE) {
+        setInt(i, dynamic_cast<const IntField &>(*f).getValue());
+    } else {
+        setString(i, dynamic_cast<const StringField &>(*f).getValue());
+    }
+}
+
+const Value &Tuple::getValue(int i) const {
+    checkIndex(i);
+    return values[i];
+}
+
+int Tuple::getInt(int i) const {
+    const Value &value = getValue(i);
+    if (value.getType() != Types::INT_TYPE) {
+        throw std::invalid_argument("Field is not an INT_TYPE.");
+    }
+    return value.getInt();
+}
+
+std::string_view Tuple::getString(int i) const {
+    const Value &value = getValue(i);
+    if (value.getType() != Types::STRING_TYPE) {
+        throw std::invalid_argument("Field is not a STRING_TYPE.");
+    }
+    return {strings.data() + value.getStringOffset(), value.getStringLength()};
+}
+
+void Tuple::setInt(int i, int value) {
+    checkIndex(i);
+    forgetField(i);
+    values[i] = Value::ofInt(value);
+}
+
+void Tuple::setString(int i, std::string_view value) {
+    checkIndex(i);
+    forgetField(i);
+    auto length = static_cast<uint32_t>(std::min(value.size(), Types::STRING_LEN - 1));
+    const Value &old = values[i];
+    if (old.getType() == Types::STRING_TYPE && length <= old.getStringLength()) {
+        // Overwrite the old characters instead of growing the buffer
+        memcpy(strings.data() + old.getStringOffset(), value.data(), length);
+        values[i] = Value::ofString(old.getStringOffset(), length);
+    } else {
+        values[i] = Value::ofString(static_cast<uint32_t>(strings.size()), length);
+        strings.append(value.data(), length);
+    }
+}
+
+void Tuple::clear() {
+    dropFields();
+    strings.clear();
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = tupleDesc->getFieldType(i) == Types::STRING_TYPE ? Value::ofString(0, 0) : Value::ofInt(0);
+    }
+}
+
+void Tuple::serializeField(int i, void *data) const {
+    const Value &value = getValue(i);
+    auto *ptr = static_cast<uint8_t *>(data);
+    if (value.getType() == Types::INT_TYPE) {
+        int32_t v = value.getInt();
+        memcpy(ptr, &v, sizeof(int));
+    } else {
+        // Same format as StringField::serialize: the length, then STRING_LEN characters
+        int len = static_cast<int>(value.getStringLength());
+        memcpy(ptr, &len, sizeof(int));
+        memcpy(ptr + sizeof(int), strings.data() + value.getStringOffset(), len);
+        memset(ptr + sizeof(int) + len, 0, Types::STRING_LEN - len);
     }
-    fields[i] = f; //Error!!!!!
 }
 
 Tuple::iterator Tuple::begin() const {
-    return fields.begin();
+    return {this, 0};
 }
 
 Tuple::iterator Tuple::end() const {
-    return fields.end();
+    return {this, static_cast<int>(values.size())};
 }
 
 std::string Tuple::to_string() const {
     std::ostringstream oss;
-    for (size_t i = 0; i < fields.size(); i++) {
+    for (size_t i = 0; i < values.size(); i++) {
         if (i != 0) {
             oss << ", ";
         }
-        oss << fields[i]->to_string();
+        if (values[i].getType() == Types::INT_TYPE) {
+            oss << values[i].getInt();
+        } else {
+            oss << getString(static_cast<int>(i));
+        }
     }
     return oss.str();
 }
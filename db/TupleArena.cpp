@@ -0,0 +1,8 @@
+#include <db/TupleArena.h>
+
+using namespace db;
+
+void *TupleArena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(latch);
+    return arena.allocate(bytes, alignment);
+}
@@ -0,0 +1,78 @@
+#include <db/TupleBatch.h>
+#include <stdexcept>
+
+using namespace db;
+
+TupleBatch::TupleBatch(std::shared_ptr<const TupleDesc> td, size_t capacity)
+        : td(std::move(td)), capacity(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("TupleBatch: capacity must be positive.");
+    }
+    size_t numFields = this->td->numFields();
+    intColumns.resize(numFields);
+    stringColumns.resize(numFields);
+    for (size_t i = 0; i < numFields; i++) {
+        if (this->td->getFieldType(i) == Types::INT_TYPE) {
+            intColumns[i].resize(capacity);
+        } else {
+            stringColumns[i].resize(capacity);
+        }
+    }
+    recordIds.resize(capacity);
+    selection.reserve(capacity);
+}
+
+const int32_t *TupleBatch::getIntColumn(int col) const {
+    if (col < 0 || col >= static_cast<int>(intColumns.size()) || td->getFieldType(col) != Types::INT_TYPE) {
+        throw std::invalid_argument("TupleBatch: field is not an INT_TYPE.");
+    }
+    return intColumns[col].data();
+}
+
+const std::string_view *TupleBatch::getStringColumn(int col) const {
+    if (col < 0 || col >= static_cast<int>(stringColumns.size()) || td->getFieldType(col) != Types::STRING_TYPE) {
+        throw std::invalid_argument("TupleBatch: field is not a STRING_TYPE.");
+    }
+    return stringColumns[col].data();
+}
+
+void TupleBatch::clear() {
+    numRows = 0;
+    selection.clear();
+    pins.clear();
+    rings.clear();
+}
+
+void TupleBatch::append(PageGuard pin, const std::vector<int> &slots, const std::vector<int> *columns,
+                        const std::shared_ptr<ScanRing> &ring) {
+    if (slots.size() > capacity - numRows) {
+        throw std::out_of_range("TupleBatch: the rows do not fit in the batch.");
+    }
+    const auto *page = dynamic_cast<const TuplePage *>(pin.get());
+    if (page == nullptr) {
+        throw std::invalid_argument("TupleBatch: not a TuplePage.");
+    }
+
+    // One call per field, so pages can copy a whole column in a tight loop
+    if (columns != nullptr && columns->size() != td->numFields()) {
+        throw std::invalid_argument("TupleBatch: one column is needed per field.");
+    }
+    for (size_t i = 0; i < td->numFields(); i++) {
+        int col = columns != nullptr ? (*columns)[i] : static_cast<int>(i);
+        if (td->getFieldType(i) == Types::INT_TYPE) {
+            page->readIntColumn(col, slots.data(), slots.size(), intColumns[i].data() + numRows);
+        } else {
+            page->readStringColumn(col, slots.data(), slots.size(), stringColumns[i].data() + numRows);
+        }
+    }
+    const PageId &pid = pin->getId();
+    for (size_t j = 0; j < slots.size(); j++) {
+        recordIds[numRows + j] = RecordId(pid, slots[j]);
+        selection.push_back(static_cast<uint32_t>(numRows + j));
+    }
+    numRows += slots.size();
+    if (ring != nullptr && (rings.empty() || rings.back() != ring)) {
+        rings.push_back(ring);
+    }
+    pins.push_back(std::move(pin));
+}
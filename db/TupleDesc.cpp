@@ -27,6 +27,7 @@ TupleDesc::TupleDesc(const std::vector<Types::Type> &types) {
         TDItem fieldDesc(type, "");
         fieldDescriptions.push_back(fieldDesc);
     }
+    computeLayout();
 }
 
 TupleDesc::TupleDesc(const std::vector<Types::Type> &types, const std::vector<std::string> &names) {
@@ -39,6 +40,17 @@ TupleDesc::TupleDesc(const std::vector<Types::Type> &types, const std::vector<st
         TDItem fieldDesc(types[i], names[i]);
         fieldDescriptions.push_back(fieldDesc);
     }
+    computeLayout();
+}
+
+void TupleDesc::computeLayout() {
+    fieldOffsets.clear();
+    size = 0;
+    // Fields are serialized one after the other, each with the fixed length of its type
+    for (const TDItem &field : fieldDescriptions) {
+        fieldOffsets.push_back(size);
+        size += Types::getLen(field.fieldType);
+    }
 }
 
 size_t TupleDesc::numFields() const {
@@ -68,14 +80,11 @@ int TupleDesc::fieldNameToIndex(const std::string &fieldName) const {
     return -1; // Field not found
 }
 
-size_t TupleDesc::getSize() const {
-    size_t totalSize = 0;
-
-    // Calculate the total size by summing the size of each field
-    for (const TDItem &field : fieldDescriptions) {
-        totalSize += Types::getLen(field.fieldType);
+size_t TupleDesc::getFieldOffset(size_t i) const {
+    if (i >= fieldOffsets.size()) {
+        throw std::out_of_range("Index out of range");
     }
-    return totalSize;
+    return fieldOffsets[i];
 }
 
 TupleDesc TupleDesc::merge(const TupleDesc &td1, const TupleDesc &td2) {
@@ -83,6 +92,7 @@ TupleDesc TupleDesc::merge(const TupleDesc &td1, const TupleDesc &td2) {
     for (const auto & fieldDescription : td2.fieldDescriptions) {
         merged_td.fieldDescriptions.push_back(fieldDescription);
     }
+    merged_td.computeLayout();
     return merged_td;
 }
 
@@ -98,7 +108,8 @@ std::string TupleDesc::to_string() const {
 }
 
 bool TupleDesc::operator==(const TupleDesc &other) const {
-    return fieldDescriptions == other.fieldDescriptions;
+    // Interned schemas are equal exactly when they are the same object
+    return this == &other || fieldDescriptions == other.fieldDescriptions;
 }
 
 TupleDesc::iterator TupleDesc::begin() const {
@@ -0,0 +1,110 @@
+#include <db/TuplePage.h>
+#include <stdexcept>
+
+using namespace db;
+
+//
+// TuplePage
+//
+
+TuplePage::~TuplePage() {
+    // The memory goes with the arena; only the tuples' destructors need to run
+    std::atomic<Tuple *> *slots = tuples.load(std::memory_order_relaxed);
+    if (slots == nullptr) {
+        return;
+    }
+    for (int slot = 0; slot < tupleCapacity; slot++) {
+        Tuple *tuple = slots[slot].load(std::memory_order_relaxed);
+        if (tuple != nullptr) {
+            tuple->~Tuple();
+        }
+    }
+}
+
+Tuple *TuplePage::newTuple(const std::shared_ptr<const TupleDesc> &td, const RecordId &rid) const {
+    return new (arena.allocate(sizeof(Tuple), alignof(Tuple))) Tuple(td, rid, &arena);
+}
+
+Tuple &TuplePage::getTuple(int slot) const {
+    if (slot < 0 || slot >= tupleCapacity || !isSlotUsed(slot)) {
+        throw std::out_of_range("TuplePage: slot is out of range or not used.");
+    }
+    std::atomic<Tuple *> *slots = tuples.load(std::memory_order_acquire);
+    if (slots == nullptr) {
+        std::pmr::polymorphic_allocator<std::atomic<Tuple *>> allocator(&arena);
+        std::atomic<Tuple *> *allocated = allocator.allocate(tupleCapacity);
+        for (int i = 0; i < tupleCapacity; i++) {
+            new (&allocated[i]) std::atomic<Tuple *>(nullptr);
+        }
+        if (tuples.compare_exchange_strong(slots, allocated, std::memory_order_acq_rel)) {
+            slots = allocated;
+        }
+    }
+
+    Tuple *tuple = slots[slot].load(std::memory_order_acquire);
+    if (tuple == nullptr) {
+        // Another thread may decode the same slot at the same time; the first one wins
+        Tuple *decoded = readTuple(slot);
+        if (slots[slot].compare_exchange_strong(tuple, decoded, std::memory_order_acq_rel)) {
+            tuple = decoded;
+        } else {
+            decoded->~Tuple();
+        }
+    }
+    return *tuple;
+}
+
+const Tuple *TuplePage::decodedTuple(int slot) const {
+    std::atomic<Tuple *> *slots = tuples.load(std::memory_order_acquire);
+    return slots == nullptr ? nullptr : slots[slot].load(std::memory_order_acquire);
+}
+
+void TuplePage::forgetTuple(int slot) {
+    std::atomic<Tuple *> *slots = tuples.load(std::memory_order_acquire);
+    if (slots != nullptr) {
+        Tuple *tuple = slots[slot].exchange(nullptr, std::memory_order_acq_rel);
+        if (tuple != nullptr) {
+            tuple->~Tuple();
+        }
+    }
+}
+
+void TuplePage::readIntColumn(int col, const int *slots, size_t count, int32_t *out) const {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = getInt(slots[i], col);
+    }
+}
+
+void TuplePage::readStringColumn(int col, const int *slots, size_t count, std::string_view *out) const {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = getStringView(slots[i], col);
+    }
+}
+
+TuplePageIterator TuplePage::begin() const {
+    return {0, this};
+}
+
+TuplePageIterator TuplePage::end() const {
+    return {getNumSlots(), this};
+}
+
+//
+// TuplePageIterator
+//
+
+TuplePageIterator::TuplePageIterator(int i, const TuplePage *page) : slot(page->nextUsedSlot(i)), page(page) {
+}
+
+bool TuplePageIterator::operator!=(const TuplePageIterator &other) const {
+    return slot != other.slot || page != other.page;
+}
+
+TuplePageIterator &TuplePageIterator::operator++() {
+    slot = page->nextUsedSlot(slot + 1);
+    return *this;
+}
+
+Tuple &TuplePageIterator::operator*() const {
+    return page->getTuple(slot);
+}
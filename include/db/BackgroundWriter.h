@@ -0,0 +1,52 @@
+#ifndef DB_BACKGROUNDWRITER_H
+#define DB_BACKGROUNDWRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace db {
+    class BufferPool;
+
+    /**
+     * Background writer of the BufferPool. Every interval, or when woken up
+     * because eviction ran out of clean pages, it writes the dirty unpinned
+     * pages of the pool back to their files in batches, so that eviction finds
+     * clean frames and foreground getPage calls do not wait on writes.
+     */
+    class BackgroundWriter {
+        BufferPool &pool;
+        std::chrono::milliseconds interval;
+
+        std::mutex latch; // Protects everything below
+        std::condition_variable wakeup;
+        std::thread thread; // Started on the first dirty page
+        bool requested = false;
+        bool stopping = false;
+
+        void run();
+
+    public:
+        /** Default time between two flush rounds. */
+        static constexpr int DEFAULT_INTERVAL_MS = 100;
+
+        BackgroundWriter(BufferPool &pool, std::chrono::milliseconds interval);
+
+        BackgroundWriter(const BackgroundWriter &) = delete;
+
+        /**
+         * Joins the writer thread. Pages still dirty are not written here; the
+         * BufferPool flushes them after destroying its writer.
+         */
+        ~BackgroundWriter();
+
+        /** Starts the writer thread if it is not running yet. */
+        void start();
+
+        /** Asks for a flush round now rather than at the next interval. */
+        void wake();
+    };
+}
+
+#endif
@@ -6,8 +6,17 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <stdexcept>
+#include <mutex>
+#include <atomic>
 #include <db/PageId.h>
+#include <db/PageKey.h>
+#include <db/ReplacementPolicy.h>
+#include <db/ReadAhead.h>
+#include <db/BackgroundWriter.h>
+#include <db/FrameArena.h>
+#include <condition_variable>
 #include <db/Catalog.h>
 #include <db/TransactionId.h>
 #include <db/Page.h>
@@ -23,16 +32,199 @@
  * locks to read/write the page.
  */
 namespace db {
+    class BufferPool;
+    class ScanRing;
+
+    /**
+     * A pin on a page of the BufferPool, or of the ScanRing it was read
+     * through. While a PageGuard holds a page, the pool will not evict it.
+     * The pin is released when the guard is destroyed, reassigned or release()
+     * is called. Guards can be moved but not copied.
+     */
+    class PageGuard {
+        friend class BufferPool;
+        BufferPool *pool = nullptr;
+        ScanRing *ring = nullptr; // Set instead of pool for ring frames
+        size_t shard = 0;
+        int frame = -1;
+        Page *page = nullptr;
+
+        PageGuard(BufferPool *pool, size_t shard, int frame, Page *page)
+                : pool(pool), shard(shard), frame(frame), page(page) {}
+
+        PageGuard(ScanRing *ring, int frame, Page *page) : ring(ring), frame(frame), page(page) {}
+
+    public:
+        PageGuard() = default;
+
+        PageGuard(const PageGuard &) = delete;
+
+        PageGuard &operator=(const PageGuard &) = delete;
+
+        PageGuard(PageGuard &&other) noexcept;
+
+        PageGuard &operator=(PageGuard &&other) noexcept;
+
+        ~PageGuard() { release(); }
+
+        /** Unpins the page. The guard is empty afterwards. */
+        void release();
+
+        /**
+         * Marks the page as modified by tid. The BufferPool writes it back to
+         * its file before the frame is reused.
+         * @throws std::logic_error if the page was read through a ScanRing,
+         *         or its file is read-only (e.g. an MMAP HeapFile)
+         */
+        void markDirty(const TransactionId &tid);
+
+        [[nodiscard]] Page *get() const { return page; }
+
+        Page *operator->() const { return page; }
+
+        Page &operator*() const { return *page; }
+
+        explicit operator bool() const { return page != nullptr; }
+    };
+
     class BufferPool {
+        friend class PageGuard;
+        friend class ReadAhead;
+        friend class BackgroundWriter;
+
         /** Default page size. Use the pageSize member instead. */
         static constexpr int PAGE_SIZE = 4096;
         /** Bytes per page, including header. */
         int pageSize = PAGE_SIZE;
 
     private:
-        std::unordered_map<PageId*, Page*> pageCache;
-        std::vector<PageId*> lruQueue; // LRU queue for eviction
+        /**
+         * A slot of the buffer pool.
+         */
+        struct Frame {
+            PageKey key{-1, -1};
+            uint8_t *data = nullptr; // pageSize bytes in the arena, where the page is read to
+            Page *page = nullptr;
+            bool loading = false;    // Being read from disk; page is not set yet
+            int pinCount = 0; // Number of PageGuards holding this frame
+            bool prefetched = false; // Loaded by read-ahead and not accessed since
+            bool dirty = false;      // Modified since it was last written
+            uint64_t dirtyVersion = 0; // Bumped on every markDirty, to detect writes racing a flush
+        };
+
+        /**
+         * A hash partition of the page table. Each shard owns a disjoint set of
+         * frames with its own replacement state, and all of it is protected by
+         * the shard's latch, so threads touching different shards never contend.
+         */
+        struct Shard {
+            std::mutex latch;
+            std::condition_variable loaded; // Signalled when a frame finishes loading
+            std::unordered_map<PageKey, int> pageTable; // Map from page key to frame index
+            std::vector<Frame> frames;                  // Frames owned by this shard
+            std::vector<int> freeFrames;                // Indices of frames holding no page
+            std::unique_ptr<ReplacementPolicy> policy;  // Chooses the frame evictPage() frees
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t numDirty = 0;
+            size_t numLoading = 0;
+
+            Shard(int numFrames, ReplacementPolicyType policyType);
+        };
+
+        /** A dirty page pinned for writing by flushDirtyPages. */
+        struct DirtyPage {
+            size_t shard;
+            int frame;
+            PageKey key;
+            Page *page;
+            uint64_t version;
+        };
+
         int capacity;
+        bool useHugePages;
+        std::unique_ptr<FrameArena> arena;          // Memory of all frames
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::atomic<size_t> nextEvictShard{0};      // Where the public evictPage() starts looking
+        std::unique_ptr<ReadAhead> readAhead;
+        std::atomic<size_t> prefetches{0};
+        std::unique_ptr<BackgroundWriter> writer;
+        std::atomic<size_t> ringReads{0};
+
+        size_t shardFor(const PageKey &key) const {
+            // The low hash bits pick the bucket inside the shard, so use the high ones here
+            return (std::hash<PageKey>{}(key) >> 32) % shards.size();
+        }
+
+        /**
+         * Looks up the page, reading it from disk on a miss, and optionally pins
+         * it. Stores the shard and frame that hold the page.
+         * @param cachedOnly return nullptr on a miss instead of reading the page
+         */
+        Page *fetch(const PageId &pid, bool pin, bool cachedOnly, size_t &shardIndex, int &frame);
+
+        /**
+         * Loads count consecutive pages of a table into the pool without
+         * pinning them, evicting if needed. The pages that are not cached yet
+         * are read with one HeapFile::readPages call per run. Called by the
+         * read-ahead I/O threads; failures are ignored.
+         */
+        void prefetchPages(int tableId, int firstPage, int count);
+
+        /** Passes a miss or first prefetched hit to the read-ahead engine. */
+        void noteSequentialCandidate(const PageKey &key, const DbFile *file);
+
+        /** (Re)allocates the arena and points every frame at its slice. */
+        void allocateFrames();
+
+        /**
+         * Claims a free frame of shard for key, evicting if the shard is full,
+         * and marks it as loading. The caller holds shard.latch.
+         * @return the frame, or -1 if every frame is pinned
+         */
+        int reserveFrame(Shard &shard, const PageKey &key);
+
+        /** Installs the page read into a reserved frame. The caller holds shard.latch. */
+        void completeLoad(Shard &shard, int frame, Page *page, bool pin, bool prefetched);
+
+        /** Frees a reserved frame whose read failed. The caller holds shard.latch. */
+        void abandonLoad(Shard &shard, int frame);
+
+        /** Releases one pin of a frame. Called by PageGuard. */
+        void unpin(size_t shardIndex, int frame);
+
+        /** Marks a pinned frame dirty. Called by PageGuard. */
+        void markDirty(size_t shardIndex, int frame, const TransactionId &tid);
+
+        /**
+         * A frame may be evicted only while it is neither pinned nor dirty.
+         * The caller holds shard.latch.
+         */
+        static void updateEvictable(Shard &shard, int frame);
+
+        /**
+         * Evicts one clean unpinned page of shard, waking the background
+         * writer if there is none. The caller holds shard.latch.
+         * @return false if every unpinned page of shard is dirty, or there is none
+         */
+        bool evictPage(Shard &shard);
+
+        /**
+         * Writes back one dirty unpinned page of shard, so that evictPage can
+         * take it. The latch held by guard is dropped during the write.
+         * @return false if shard has no dirty unpinned page
+         */
+        bool writeBackPage(Shard &shard, std::unique_lock<std::mutex> &guard);
+
+        /**
+         * Writes the dirty pages of the pool, merging pages with consecutive
+         * page numbers of the same file into one write.
+         * @param includePinned also write pages that are currently pinned
+         */
+        void flushDirtyPages(bool includePinned);
+
+        /** Writes pinned dirty pages and marks them clean, then unpins them. */
+        void writeDirtyPages(std::vector<DirtyPage> &pages);
 
     public:
         BufferPool(const BufferPool &) = delete; //This implies we cannot create a copy of a BufferPool object. If we attempt to do so, the compiler will generate an error.
@@ -44,11 +236,38 @@ namespace db {
          */
         static constexpr int DEFAULT_PAGES = 50;
 
+        /**
+         * Smallest number of frames per shard chosen automatically. Smaller pools
+         * use a single shard so that they evict exactly like an unsharded pool.
+         */
+        static constexpr int MIN_FRAMES_PER_SHARD = 64;
+
+        /** Default number of pages read ahead of a sequential scan. */
+        static constexpr int DEFAULT_PREFETCH_DEPTH = 8;
+
+        /** Number of background I/O threads used for read-ahead. */
+        static constexpr int PREFETCH_THREADS = 2;
+
+        /**
+         * Scans of files with more than 1/SCAN_RING_FRACTION of the pool
+         * capacity in pages read through a ScanRing.
+         */
+        static constexpr int SCAN_RING_FRACTION = 4;
+
         /**
          * Creates a BufferPool that caches up to numPages pages.
          * @param numPages maximum number of pages in this buffer pool.
+         * @param policyType the replacement policy used to pick eviction victims.
+         * @param numShards number of independently latched partitions of the
+         *        page table; 0 picks one from the pool size and core count.
+         * @param useHugePages back the frame arena with 2MB huge pages if the
+         *        kernel allows it.
          */
-        explicit BufferPool(int numPages);
+        explicit BufferPool(int numPages, ReplacementPolicyType policyType = ReplacementPolicyType::LRU,
+                            int numShards = 0, bool useHugePages = false);
+
+        /** Writes back the dirty pages, then frees every page still held by the buffer pool. */
+        ~BufferPool();
 
         /**
          * Retrieve the specified page.
@@ -60,21 +279,120 @@ namespace db {
          * be added to the buffer pool and returned.  If there is insufficient
          * space in the buffer pool, an page should be evicted and the new page
          * should be added in its place.
+         * <p>
+         * Safe to call from multiple threads; only the shard owning pid is
+         * latched, and it is released while the page is read from disk.
          *
          * @param tid the ID of the transaction requesting the page
          * @param pid the ID of the requested page
+         * @return a guard pinning the page, which stays resident until the
+         *         guard is released; the same as fetchPage(tid, *pid)
+         * @throws std::runtime_error if the page is not cached and every frame
+         *         of its shard is pinned
+         */
+        [[nodiscard]] PageGuard getPage(const TransactionId &tid, PageId *pid);
+
+        /**
+         * Retrieve the specified page like getPage, and pin it until the
+         * returned guard is released.
+         *
+         * @param tid the ID of the transaction requesting the page
+         * @param pid the ID of the requested page
+         * @throws std::runtime_error if the page is not cached and every frame
+         *         of its shard is pinned
+         */
+        PageGuard fetchPage(const TransactionId &tid, const PageId &pid);
+
+        /**
+         * Retrieve the specified page for a sequential scan. A page already in
+         * the pool is pinned there; otherwise it is read into the ring, and the
+         * shared frames and their replacement state are untouched. A miss reads
+         * up to the prefetch depth of following pages into the ring in the
+         * same batch; they count as prefetched pages.
+         *
+         * @param ring the ring of the scan, or nullptr to use the shared frames
+         * @throws std::runtime_error if every frame of the ring is pinned
+         */
+        PageGuard fetchPage(const TransactionId &tid, const PageId &pid, ScanRing *ring);
+
+        /**
+         * Creates the ring a sequential scan of a file should read through.
+         * @param numPages number of pages of the scanned file
+         * @return a new ring, or nullptr if the file is small enough to be
+         *         scanned through the shared frames
          */
-        Page *getPage(const TransactionId &tid, PageId *pid);
+        [[nodiscard]] std::unique_ptr<ScanRing> createScanRing(int numPages) const;
 
         [[nodiscard]] size_t getPageSize() const { return pageSize; }
 
-        /** DO NOT USE */
-        void setPageSize(int newPageSize) { pageSize = newPageSize; }
+        /**
+         * DO NOT USE
+         * Discards every cached page and reallocates the frames.
+         */
+        void setPageSize(int newPageSize);
 
         /** DO NOT USE */
         void resetPageSize() { setPageSize(PAGE_SIZE); }
 
+        /**
+         * Discards one unpinned page, chosen by the replacement policy of a
+         * non-empty shard, from the buffer pool and frees its frame.
+         * @throws std::runtime_error if the buffer pool holds no unpinned pages
+         */
         void evictPage();
+
+        /**
+         * Writes the specified page to disk if it is cached and dirty, and
+         * marks it clean.
+         */
+        void flushPage(const PageId &pid);
+
+        /**
+         * Writes every dirty page of the pool to disk, e.g. for a checkpoint.
+         * Pages are written in file and page order, with consecutive pages of a
+         * file merged into one sequential write.
+         */
+        void flushAllPages();
+
+        /** @return the number of cached pages that are dirty */
+        [[nodiscard]] size_t getNumDirtyPages() const;
+
+        /** @return the number of pages read ahead of a sequential scan */
+        [[nodiscard]] int getPrefetchDepth() const { return readAhead->getDepth(); }
+
+        /**
+         * Sets how many pages are read ahead of a sequential scan by the
+         * background I/O threads. 0 disables read-ahead.
+         */
+        void setPrefetchDepth(int depth) { readAhead->setDepth(depth); }
+
+        /** @return the number of pages loaded by read-ahead so far, into the pool or a scan ring */
+        [[nodiscard]] size_t getPrefetchCount() const { return prefetches; }
+
+        /** @return the number of pages read into scan rings instead of the pool */
+        [[nodiscard]] size_t getRingReadCount() const { return ringReads; }
+
+        /** @return true if the frame arena is backed by huge pages */
+        [[nodiscard]] bool usesHugePages() const { return arena->usesHugePages(); }
+
+        /** @return the number of shards the page table is split into */
+        [[nodiscard]] size_t getNumShards() const { return shards.size(); }
+
+        /** @return the number of pages currently cached */
+        [[nodiscard]] size_t getNumCachedPages() const;
+
+        /** @return the number of getPage calls served from the cache */
+        [[nodiscard]] size_t getHitCount() const;
+
+        /** @return the number of getPage calls that had to read from disk */
+        [[nodiscard]] size_t getMissCount() const;
+
+        /** @return hits / (hits + misses), or 0 before the first getPage */
+        [[nodiscard]] double getHitRatio() const {
+            size_t hits = getHitCount();
+            size_t misses = getMissCount();
+            return hits + misses == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
     };
 }
 
@@ -5,7 +5,9 @@
 #include <db/DbFile.h>
 #include <db/Utility.h>
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace db {
 
@@ -13,8 +15,10 @@ namespace db {
         DbFile *file;
         std::string name;
         std::string pkeyField;
+        std::shared_ptr<const TupleDesc> td; // Interned schema of the file
 
-        Table(DbFile *file, std::string name, std::string pkeyField) : file(file), name(std::move(name)), pkeyField(std::move(pkeyField)) {}
+        Table(DbFile *file, std::string name, std::string pkeyField, std::shared_ptr<const TupleDesc> td)
+                : file(file), name(std::move(name)), pkeyField(std::move(pkeyField)), td(std::move(td)) {}
     };
 
     /**
@@ -23,12 +27,17 @@ namespace db {
      * For now, this is a stub catalog that must be populated with tables by a
      * user program before it can be used -- eventually, this should be converted
      * to a catalog that reads a catalog table from disk.
+     * <p>
+     * Schemas are interned: tables with equal TupleDescs share one instance,
+     * which pages and tuples reference instead of copying it, so two interned
+     * schemas are equal exactly when they are the same object.
      */
     class Catalog {
 
     private:
         std::unordered_map<std::string, int> idByName; // Map from table name to ID
-        std::unordered_map<int, Table*> tablesById; // Map from table ID to Table
+        std::unordered_map<int, std::unique_ptr<Table>> tablesById; // Map from table ID to Table
+        std::vector<std::shared_ptr<const TupleDesc>> schemas; // Distinct schemas of the tables
 
     public:
         // disable copy
@@ -74,6 +83,23 @@ namespace db {
          */
         const TupleDesc &getTupleDesc(int tableId) const;
 
+        /**
+         * Returns the interned tuple descriptor of the specified table, for
+         * holders that keep a reference to it, such as pages and tuples.
+         * @param tableId The id of the table, as specified by the DbFile.getId()
+         *     function passed to addTable
+         */
+        const std::shared_ptr<const TupleDesc> &getSharedTupleDesc(int tableId) const;
+
+        /**
+         * @return the interned instance of td, adding td if no table uses an
+         *     equal schema yet
+         * @note Meant for table schemas while tables are added: it is not
+         *     synchronized and never forgets a schema, so it must not be called
+         *     on the query path.
+         */
+        std::shared_ptr<const TupleDesc> intern(const TupleDesc &td);
+
         /**
          * Returns the DbFile that can be used to read the contents of the
          * specified table.
@@ -5,6 +5,8 @@
 #include <db/Tuple.h>
 #include <db/TransactionId.h>
 #include <db/Page.h>
+#include <memory>
+#include <vector>
 
 namespace db {
     /**
@@ -21,6 +23,41 @@ namespace db {
          */
         [[nodiscard]] virtual Page *readPage(const PageId &id) const = 0;
 
+        /**
+         * Read the specified page from disk into a BufferPool frame. The
+         * returned page may keep referring to frame, which outlives it.
+         * Files that cannot read in place ignore frame.
+         *
+         * @param frame pageSize bytes of page-aligned memory
+         */
+        [[nodiscard]] virtual Page *readPage(const PageId &id, [[maybe_unused]] uint8_t *frame) const { return readPage(id); }
+
+        /**
+         * Push the specified page to disk.
+         *
+         * @param page The page to write. page.getId().pageNumber() specifies the
+         *             offset into the file where the page should be written.
+         */
+        virtual void writePage(Page *page) const = 0;
+
+        /**
+         * Push several pages of this file to disk. Implementations may merge
+         * pages with consecutive page numbers into a single write.
+         *
+         * @param pages the pages to write, sorted by page number
+         */
+        virtual void writePages(const std::vector<Page *> &pages) const {
+            for (Page *page : pages) {
+                writePage(page);
+            }
+        }
+
+        /**
+         * @return true if pages of this file can never be written back, so
+         *         the BufferPool refuses to mark them dirty
+         */
+        [[nodiscard]] virtual bool isReadOnly() const { return false; }
+
         /**
          * Returns a unique ID used to identify this DbFile in the Catalog. This id
          * can be used to look up the table via {@link Catalog#getDatabaseFile} and
@@ -42,6 +79,14 @@ namespace db {
          */
         [[nodiscard]] virtual const TupleDesc &getTupleDesc() const = 0;
 
+        /**
+         * Called by the Catalog when the file is added, with the interned
+         * instance of getTupleDesc(). Files that keep it return it from
+         * getTupleDesc afterwards, so their schema compares equal to the
+         * other interned schemas by address.
+         */
+        virtual void setInternedTupleDesc(std::shared_ptr<const TupleDesc>) {}
+
         virtual ~DbFile() = default;
     };
 }
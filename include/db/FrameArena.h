@@ -0,0 +1,47 @@
+#ifndef DB_FRAMEARENA_H
+#define DB_FRAMEARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace db {
+    /**
+     * One contiguous, page-aligned block of memory holding the frames of a
+     * BufferPool. It is allocated once, when the pool is created, so cache
+     * misses never allocate page buffers and the pool has a fixed footprint.
+     */
+    class FrameArena {
+        uint8_t *base = nullptr;
+        size_t bytes = 0;
+        size_t frameSize;
+        bool hugePages = false;
+
+    public:
+        /** Size of a transparent huge page on x86-64 and arm64. */
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        /**
+         * @param numFrames number of frames in the arena
+         * @param frameSize bytes per frame (the page size)
+         * @param useHugePages ask the kernel to back the arena with 2MB pages
+         *        (madvise(MADV_HUGEPAGE)); ignored if the kernel refuses
+         */
+        FrameArena(size_t numFrames, size_t frameSize, bool useHugePages);
+
+        FrameArena(const FrameArena &) = delete;
+
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        ~FrameArena();
+
+        /** @return the memory of frame i */
+        [[nodiscard]] uint8_t *frame(size_t i) const { return base + i * frameSize; }
+
+        /** @return true if the kernel accepted the huge page hint */
+        [[nodiscard]] bool usesHugePages() const { return hugePages; }
+
+        [[nodiscard]] size_t size() const { return bytes; }
+    };
+}
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef DB_HEAPFILE_H
+#define DB_HEAPFILE_H
+
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -7,21 +10,113 @@
 #include <db/PageId.h>
 #include <db/TransactionId.h>
 #include <db/HeapPage.h>
+#include <db/PaxPage.h>
+#include <db/SlottedPage.h>
+#include <db/BufferPool.h>
+#include <db/ScanRing.h>
+#include <db/TupleBatch.h>
+#include <db/Predicate.h>
+#include <db/Projection.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
 
 namespace db {
     class HeapFile;
+
+    /** Layout of the pages of a HeapFile. */
+    enum class PageFormat {
+        /** Fixed-size slots and a header bitmap; see HeapPage. */
+        HEAP,
+        /** Variable-length records and a slot directory; see SlottedPage. */
+        SLOTTED,
+        /** The slots of a HeapPage, stored column by column; see PaxPage. */
+        PAX
+    };
+
+    /** How a HeapFile accesses its backing file. */
+    enum class IoMode {
+        /** pread/pwrite through the kernel page cache. */
+        BUFFERED,
+        /**
+         * Read-only. The file is mapped into memory and pages are read in place
+         * from the mapping, without copying them into buffer pool frames.
+         */
+        MMAP,
+        /**
+         * O_DIRECT: pages move between the disk and aligned buffer pool frames
+         * without going through the kernel page cache. The page size must be a
+         * multiple of HeapFile::DIRECT_IO_ALIGNMENT.
+         */
+        DIRECT
+    };
+
+    /**
+     * Iterates over the tuples of a HeapFile, page by page, through the
+     * BufferPool. The page being iterated stays pinned until the iterator moves
+     * past it, so the tuple returned by operator* remains valid until then.
+     * <p>
+     * Files larger than a fraction of the pool are read through a private
+     * ScanRing so that scanning them does not flush the cached pages.
+     * <p>
+     * Given predicates, the iterator only stops at the rows that satisfy all
+     * of them. They are evaluated on each page's bytes as it is pinned, so no
+     * Tuple is built for the other rows.
+     * <p>
+     * Given a projection, operator* returns a tuple of the projected fields
+     * only, read straight from the page bytes into a tuple owned by the
+     * iterator. It remains valid until the iterator moves.
+     *
+     * @see db::BufferPool::createScanRing
+     */
     class HeapFileIterator {
     private:
         const HeapFile *heapFile;
+        TransactionId tid;
         int currentPage;
-        int currentTupleIndex;
-        //HeapPageIterator tupleIter;
+        int numPages;
+        const std::vector<Predicate> *predicates; // Conjunction the rows must satisfy, or null
+        const Projection *projection;             // Fields to return, or null for all
+        mutable Tuple projected;                   // Projected tuple of the current row
+        mutable bool projectedValid = false;       // Whether projected holds the current row
+        std::shared_ptr<ScanRing> ring;            // Frames of a large scan, shared with batches; must outlive the pin in guard
+        PageGuard guard;                           // Pin on currentPage
+        std::vector<int> slots;                    // Used and matching slots of currentPage
+        size_t slotIndex = 0;                      // Position in slots
+        std::vector<int> batchSlots;               // Reused by nextBatch
+
+        /** Moves to the first matching row at or after currentPage. */
+        void seekNonEmptyPage();
 
     public:
-        HeapFileIterator(const HeapFile *heapFile, int currentPage);
+        /**
+         * @param predicates rows to return, all of them if null; must outlive
+         *        the iterator
+         * @param projection fields to return, all of them if null; must
+         *        outlive the iterator
+         */
+        HeapFileIterator(const HeapFile *heapFile, int currentPage, const TransactionId &tid = TransactionId(),
+                         const std::vector<Predicate> *predicates = nullptr, const Projection *projection = nullptr);
+
+        HeapFileIterator(HeapFileIterator &&other) noexcept = default;
+
+        /** Releases the pin on the current page before taking over the ring of other. */
+        HeapFileIterator &operator=(HeapFileIterator &&other) noexcept;
+
         bool operator!=(const HeapFileIterator &other) const;
-        Tuple &operator*();
+        Tuple &operator*() const;
         HeapFileIterator &operator++();
+
+        /**
+         * Replaces the contents of batch with the next rows of the file, read
+         * column by column from the pages, and moves past them. With a
+         * projection, only the projected fields are read.
+         * @return the number of rows read, 0 at the end of the file
+         * @throws std::invalid_argument if batch is not for the schema of the
+         *         file, or of the projection
+         */
+        size_t nextBatch(TupleBatch &batch);
     };
 
     /**
@@ -29,23 +124,77 @@ namespace db {
      * in no particular order. Tuples are stored on pages, each of which is a fixed
      * size, and the file is simply a collection of those pages. HeapFile works
      * closely with HeapPage. The format of HeapPages is described in the HeapPage
-     * constructor.
+     * constructor. A file can store its pages as SlottedPages or PaxPages
+     * instead, chosen per table when the file is created.
      *
      * @see db::HeapPage::HeapPage
+     * @see db::SlottedPage
+     * @see db::PaxPage
      * @author Sam Madden
      */
     class HeapFile : public DbFile {
         const char *fname;
-        TupleDesc td;
+        std::shared_ptr<const TupleDesc> td; // The Catalog's interned instance once the file is added
+        IoMode mode;
+        PageFormat format;
+        int fd = -1;                       // Open for the lifetime of the HeapFile
+        mutable std::atomic<off_t> fileSize; // Bytes in the file; grown by writePages
+
+        /** A mapping of the file in MMAP mode. */
+        struct Mapping {
+            uint8_t *base;
+            size_t length;
+        };
+
+        mutable std::mutex mapLatch;          // Protects mappings
+        // Every mapping made so far. The last one covers the whole file; older
+        // ones stay mapped because cached pages may still point into them.
+        mutable std::vector<Mapping> mappings;
+
+        /** Creates the page object of the file format over page bytes. */
+        TuplePage *newPage(const HeapPageId &pid, uint8_t *data, bool inPlace) const;
+
+        /**
+         * Reads the bytes of page pageNo into data. Bytes past the end of the
+         * file read as zero.
+         */
+        void readPageData(int pageNo, uint8_t *data) const;
+
+        /**
+         * Re-reads the file size and, in MMAP mode, maps the file again if it
+         * grew. The caller holds mapLatch.
+         */
+        void refreshSize() const;
+
+        /**
+         * In MMAP mode, returns the address of page pageNo in the mapping.
+         * @throws std::runtime_error if the page is past the end of the file
+         */
+        const uint8_t *mappedPage(int pageNo) const;
 
     public:
+        /** Alignment of buffers, offsets and lengths of O_DIRECT transfers. */
+        static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
 
         /**
-         * Constructs a heap file backed by the specified file.
+         * Constructs a heap file backed by the specified file. The file is
+         * created if it does not exist, and stays open until the HeapFile is
+         * destroyed.
          *
          * @param f the file that stores the on-disk backing store for this heap file.
+         * @param mode how the file is read and written. In MMAP mode the file
+         *        is not created and cannot be written.
+         * @param format the layout of the pages of the file
+         * @throws std::runtime_error if the file cannot be opened or mapped, or
+         *         its file system does not support O_DIRECT in DIRECT mode
          */
-        HeapFile(const char *fname, TupleDesc td);
+        HeapFile(const char *fname, TupleDesc td, IoMode mode = IoMode::BUFFERED, PageFormat format = PageFormat::HEAP);
+
+        HeapFile(const HeapFile &) = delete;
+
+        HeapFile &operator=(const HeapFile &) = delete;
+
+        ~HeapFile() override;
 
         /**
          * Returns an ID uniquely identifying this HeapFile. Implementation note:
@@ -59,19 +208,70 @@ namespace db {
 
         /**
          * Returns the TupleDesc of the table stored in this DbFile.
-         * @return TupleDesc of this DbFile.
+         * @return TupleDesc of this DbFile; the Catalog's interned instance
+         *         once the file has been added to the Catalog.
          */
         [[nodiscard]] const TupleDesc &getTupleDesc() const override;
 
+        /** Replaces the schema of the file with the equal interned one. */
+        void setInternedTupleDesc(std::shared_ptr<const TupleDesc> interned) override;
+
         Page *readPage(const PageId &pid) const override;
 
         /**
-         * Returns the number of pages in this HeapFile.
+         * Reads the page straight into the frame; the returned page works on
+         * the frame bytes in place. In MMAP mode the frame is not used and the
+         * page works on the mapping instead.
+         */
+        Page *readPage(const PageId &pid, uint8_t *frame) const override;
+
+        /**
+         * Reads count consecutive pages starting at firstPage, page i into
+         * frames[i], as readPage(pid, frame) would. The reads are submitted
+         * together through io_uring, or made one by one with pread if
+         * io_uring is not available.
+         * @return the pages, in page order
+         */
+        std::vector<Page *> readPages(int firstPage, int count, const std::vector<uint8_t *> &frames) const;
+
+        /** @throws std::logic_error in MMAP mode */
+        void writePage(Page *page) const override;
+
+        /**
+         * Writes the pages, merging runs of consecutive page numbers into one
+         * sequential write each.
+         * @throws std::logic_error in MMAP mode
+         */
+        void writePages(const std::vector<Page *> &pages) const override;
+
+        [[nodiscard]] IoMode getIoMode() const { return mode; }
+
+        /** @return true in MMAP mode, whose mapping is read-only */
+        [[nodiscard]] bool isReadOnly() const override { return mode == IoMode::MMAP; }
+
+        [[nodiscard]] PageFormat getPageFormat() const { return format; }
+
+        /**
+         * Tells the kernel that a scan is about to read pages
+         * [firstPage, firstPage + numPages), so it can read them in the
+         * background. Only has an effect in MMAP mode.
+         */
+        void willNeed(int firstPage, int numPages) const;
+
+        /**
+         * Returns the number of pages in this HeapFile. The file size is cached,
+         * so this does not touch the file.
          */
         int getNumPages() const;
 
+        /**
+         * In MMAP mode, the file size is read again here, so that a new scan
+         * sees pages appended by other writers.
+         */
         [[nodiscard]] HeapFileIterator begin() const;
 
         [[nodiscard]] HeapFileIterator end() const;
     };
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
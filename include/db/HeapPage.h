@@ -4,39 +4,90 @@
 #include <db/HeapPageId.h>
 #include <db/Tuple.h>
 #include <db/Page.h>
+#include <db/TuplePage.h>
 #include <db/Catalog.h>
 #include <db/BufferPool.h>
 #include <db/Database.h>
+#include <atomic>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <vector>
 #include <fstream>
 #include <mutex>
 #include <optional>
 #include <cstring>
+#include <string_view>
 
 namespace db {
-    class HeapPageIterator;
+    using HeapPageIterator = TuplePageIterator;
+
     /**
      * Each instance of HeapPage stores data for one page of HeapFiles and
      * implements the Page interface that is used by BufferPool.
+     * <p>
+     * The page keeps its raw bytes and decodes nothing up front; tuples are
+     * built on demand through the TuplePage interface.
      *
      * @see HeapFile
      * @see BufferPool
      *
      */
-    class HeapPage : public Page {
-        friend class HeapPageIterator;
+    class HeapPage : public TuplePage {
+    protected:
+        /**
+         * Where the values of a field live: the value of slot i is at
+         * offset + i * stride in the page bytes.
+         */
+        struct FieldLayout {
+            size_t offset;
+            size_t stride;
+            Types::Type type;
+        };
+
+        std::vector<FieldLayout> layout;
+
+        /**
+         * Create a page over the bytes of a page of a HeapFile.
+         * @param columnar store the values of each field contiguously after
+         *        the header (PAX) instead of one tuple after the other
+         */
+        HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar);
+
+        /** @return the bytes of field col of the tuple in slot */
+        [[nodiscard]] uint8_t *fieldAt(int slot, int col) const {
+            return data + layout[col].offset + slot * layout[col].stride;
+        }
+
+    private:
         HeapPageId pid;
-        TupleDesc td;
-        uint8_t *header;
-        Tuple *tuples;
+        std::shared_ptr<const TupleDesc> td; // Interned by the Catalog
+        uint8_t *data;   // Page bytes: the header, then the slots
+        bool ownsData;   // False when data points into a BufferPool frame
+        size_t tupleSize;
+        int headerSize;
         int numSlots;
+        std::optional<TransactionId> dirtier; // Set while the page is dirty
+
+        // Look the page size and TupleDesc up once, then build the page from them
+        HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar, size_t pageSize);
+
+        HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace, bool columnar, size_t pageSize,
+                 const std::shared_ptr<const TupleDesc> &td);
 
         /**
          * Suck up tuples from the source file.
          */
-        void readTuple(Tuple *t, uint8_t *data, int slotId);
+        Tuple *readTuple(int slotId) const override;
+
+        /** @return the bytes of field col of the tuple in slot, checking both and the type */
+        [[nodiscard]] const uint8_t *fieldData(int slot, int col, Types::Type type) const;
+
+        /**
+         * @return the header bits of slots [64 * word, 64 * word + 64), slot i
+         *         in bit i % 64. Bits of slots past numSlots are zero.
+         */
+        [[nodiscard]] uint64_t headerWord(int word) const;
 
     public:
         /**
@@ -57,6 +108,15 @@ namespace db {
          */
         HeapPage(const HeapPageId &id, uint8_t *data);
 
+        /**
+         * Create a HeapPage over page bytes that live in a BufferPool frame.
+         * With inPlace set, the page keeps reading from data instead of copying
+         * it, so data must outlive the page.
+         */
+        HeapPage(const HeapPageId &id, uint8_t *data, bool inPlace);
+
+        ~HeapPage() override;
+
         /** Retrieve the number of tuples on this page.
             @return the number of tuples on this page
         */
@@ -86,6 +146,10 @@ namespace db {
          */
         void *getPageData() override;
 
+        void markDirty(bool dirty, const TransactionId &tid) override;
+
+        [[nodiscard]] const TransactionId *isDirty() const override;
+
         /**
          * Static method to generate a byte array corresponding to an empty
          * HeapPage.
@@ -97,37 +161,29 @@ namespace db {
          */
         static uint8_t *createEmptyPageData();
 
-        /**
-         * Returns the number of empty slots on this page.
-         */
-        [[nodiscard]] int getNumEmptySlots() const;
+        [[nodiscard]] int getNumSlots() const override { return numSlots; }
+
+        [[nodiscard]] int getNumEmptySlots() const override;
+
+        [[nodiscard]] bool isSlotUsed(int i) const override;
+
+        [[nodiscard]] int nextUsedSlot(int from) const override;
 
         /**
-         * Returns true if associated slot on this page is filled.
+         * @return the first empty slot at or after slot from, for inserts, or
+         *         -1 if the page is full from there on
          */
-        [[nodiscard]] bool isSlotUsed(int i) const;
+        [[nodiscard]] int nextFreeSlot(int from = 0) const;
 
-        // Begin and End methods for iterators
-        [[nodiscard]] HeapPageIterator begin() const;
-
-        [[nodiscard]] HeapPageIterator end() const;
-    };
+        size_t getUsedSlots(std::vector<int> &slots) const override;
 
-    /**
-     * @return an iterator over all tuples on this page
-     * (note that this iterator shouldn't return tuples in empty slots!)
-     */
-    class HeapPageIterator {
-        int slot;
-        const HeapPage *page;
-    public:
-        HeapPageIterator(int slot, const HeapPage *page);
+        [[nodiscard]] int getInt(int slot, int col) const override;
 
-        bool operator!=(const HeapPageIterator &other) const;
+        [[nodiscard]] std::string_view getStringView(int slot, int col) const override;
 
-        Tuple &operator*() const;
+        void readIntColumn(int col, const int *slots, size_t count, int32_t *out) const override;
 
-        HeapPageIterator &operator++();
+        void readStringColumn(int col, const int *slots, size_t count, std::string_view *out) const override;
     };
 }
 
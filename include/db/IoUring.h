@@ -0,0 +1,92 @@
+#ifndef DB_IOURING_H
+#define DB_IOURING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace db {
+    /**
+     * A minimal io_uring instance used to submit many page reads with one
+     * system call and keep the device busy at a high queue depth. It talks to
+     * the kernel through the raw io_uring_setup/io_uring_enter system calls.
+     * <p>
+     * If the kernel does not support io_uring, or it is disabled, available()
+     * is false and callers fall back to pread.
+     * <p>
+     * An IoUring is not thread-safe; use forThisThread().
+     */
+    class IoUring {
+        int ringFd = -1;
+        void *sqRing = nullptr;
+        size_t sqRingSize = 0;
+        void *cqRing = nullptr;
+        size_t cqRingSize = 0;
+        io_uring_sqe *sqes = nullptr;
+        size_t sqesSize = 0;
+
+        unsigned *sqHead = nullptr;
+        unsigned *sqTail = nullptr;
+        unsigned sqMask = 0;
+        unsigned sqEntries = 0;
+        unsigned *sqArray = nullptr;
+        unsigned *cqHead = nullptr;
+        unsigned *cqTail = nullptr;
+        unsigned cqMask = 0;
+        io_uring_cqe *cqes = nullptr;
+
+        /** Unmaps the rings and closes the ring descriptor. */
+        void close();
+
+        /**
+         * Waits for and discards the completions of reads already submitted.
+         * @param inFlight the number of submitted reads not completed yet
+         */
+        void drain(unsigned inFlight);
+
+    public:
+        /** One read of a batch. */
+        struct Read {
+            int fd;
+            uint8_t *buffer;
+            size_t length;
+            off_t offset;
+            ssize_t result = 0; // Bytes read, or -errno
+        };
+
+        /** Default number of submission queue entries. */
+        static constexpr unsigned DEFAULT_ENTRIES = 64;
+
+        explicit IoUring(unsigned entries = DEFAULT_ENTRIES);
+
+        IoUring(const IoUring &) = delete;
+
+        IoUring &operator=(const IoUring &) = delete;
+
+        ~IoUring();
+
+        /** @return true if the kernel set up the ring */
+        [[nodiscard]] bool available() const { return ringFd != -1; }
+
+        /**
+         * Submits the reads, as many at a time as the queue holds, and waits
+         * until all of them have completed. The outcome of each read is stored
+         * in its result; a short read is not retried.
+         * <p>
+         * If io_uring_enter fails, the reads already submitted are waited for
+         * and the ring is closed, so available() is false afterwards.
+         * @throws std::runtime_error if the ring is not available or
+         *         io_uring_enter fails
+         */
+        void read(std::vector<Read> &reads);
+
+        /** @return the ring of the calling thread, created on first use */
+        static IoUring &forThisThread();
+    };
+}
+
+#endif
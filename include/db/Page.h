@@ -11,6 +11,18 @@ namespace db {
 
         virtual void *getPageData() = 0;
 
+        /**
+         * Set the dirty state of this page as dirty or clean, and record the
+         * transaction that did the dirtying.
+         */
+        virtual void markDirty(bool dirty, const TransactionId &tid) = 0;
+
+        /**
+         * @return the transaction that last dirtied this page, or nullptr if
+         *         the page is not dirty
+         */
+        [[nodiscard]] virtual const TransactionId *isDirty() const = 0;
+
         virtual ~Page() = default;
     };
 }
@@ -0,0 +1,41 @@
+#ifndef DB_PAGEKEY_H
+#define DB_PAGEKEY_H
+
+#include <db/PageId.h>
+#include <cstdint>
+#include <functional>
+
+namespace db {
+    /**
+     * Compact value key of a cached page. Two PageId objects that refer to the
+     * same page of the same table map to the same PageKey.
+     */
+    struct PageKey {
+        int tableId;
+        int pageNo;
+
+        PageKey(int tableId, int pageNo) : tableId(tableId), pageNo(pageNo) {}
+
+        explicit PageKey(const PageId &pid) : tableId(pid.getTableId()), pageNo(pid.pageNumber()) {}
+
+        bool operator==(const PageKey &other) const { return tableId == other.tableId && pageNo == other.pageNo; }
+
+        bool operator!=(const PageKey &other) const { return !(*this == other); }
+    };
+}
+
+template<>
+struct std::hash<db::PageKey> {
+    std::size_t operator()(const db::PageKey &k) const {
+        // Pack both ints into one 64-bit word and mix it (splitmix64 finalizer)
+        uint64_t x = (static_cast<uint64_t>(static_cast<uint32_t>(k.tableId)) << 32) | static_cast<uint32_t>(k.pageNo);
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return static_cast<std::size_t>(x);
+    }
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef DB_PARALLELSEQSCAN_H
+#define DB_PARALLELSEQSCAN_H
+
+#include <db/HeapFile.h>
+#include <db/TransactionId.h>
+#include <db/Tuple.h>
+#include <functional>
+
+namespace db {
+    /**
+     * A sequential scan that reads a table with several threads. The pages of
+     * the HeapFile are split into morsels, ranges of consecutive pages, which
+     * the worker threads claim one after the other, so faster workers simply
+     * scan more of them. Workers read through the shared BufferPool, each
+     * with its own ScanRing for tables larger than a fraction of the pool.
+     * <p>
+     * run delivers the tuples to the workers' consumers as they are read, in
+     * no particular order; runOrdered delivers them on the calling thread in
+     * the order of a SeqScan.
+     */
+    class ParallelSeqScan {
+        TransactionId *tid;
+        int tableid;
+        int numWorkers;
+        int morselPages;
+
+        /** @return the file of the table, checking it is a HeapFile */
+        [[nodiscard]] const HeapFile *scannedFile() const;
+
+        /** @return the number of workers worth starting for numMorsels morsels */
+        [[nodiscard]] int workersFor(int numMorsels) const;
+
+    public:
+        /** Default number of pages in a morsel. */
+        static constexpr int DEFAULT_MORSEL_PAGES = 64;
+
+        /**
+         * @param tid the transaction this scan is running as a part of
+         * @param tableid the table to scan, stored in a HeapFile
+         * @param numWorkers the number of threads; 0 means one per core
+         * @param morselPages the number of pages a worker claims at once
+         * @throws std::invalid_argument if numWorkers is negative or morselPages is not positive
+         */
+        ParallelSeqScan(TransactionId *tid, int tableid, int numWorkers = 0, int morselPages = DEFAULT_MORSEL_PAGES);
+
+        [[nodiscard]] int getNumWorkers() const { return numWorkers; }
+
+        /**
+         * Scans the table, calling consumer(worker, tuple) for every tuple
+         * from the worker thread that read it, numbered from 0. Calls from
+         * different workers run concurrently; a tuple is valid during the
+         * call only. Returns when all tuples have been consumed.
+         * @throws the first exception thrown by a worker or by consumer
+         */
+        void run(const std::function<void(int worker, const Tuple &tuple)> &consumer) const;
+
+        /**
+         * Scans the table, calling consumer(tuple) on the calling thread for
+         * every tuple, in file order. Workers read ahead by at most two
+         * morsels each and copy the tuples of a morsel until it is consumed.
+         * @throws the first exception thrown by a worker or by consumer
+         */
+        void runOrdered(const std::function<void(const Tuple &tuple)> &consumer) const;
+    };
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef DB_PAXPAGE_H
+#define DB_PAXPAGE_H
+
+#include <db/HeapPage.h>
+
+namespace db {
+    /**
+     * A HeapPage whose tuples are stored column by column (PAX). The header
+     * bitmap and the number of slots are those of a HeapPage, but after the
+     * header come all the values of the first field, then all the values of
+     * the second one, and so on. A scan reading one or two fields touches
+     * dense arrays of them instead of striding over whole tuples.
+     * <p>
+     * A HeapFile stores its pages in this format when it is created with
+     * PageFormat::PAX; scans see it through the TuplePage interface like any
+     * other page.
+     */
+    class PaxPage : public HeapPage {
+    public:
+        /**
+         * @param inPlace keep reading from data instead of copying it, so data
+         *        must outlive the page
+         */
+        PaxPage(const HeapPageId &id, uint8_t *data, bool inPlace);
+
+        /**
+         * @return the values of field col of every slot, used or not, one after
+         *         the other, each Types::getLen(type) bytes long
+         * @throws std::out_of_range if col is out of range
+         */
+        [[nodiscard]] const uint8_t *getColumn(int col) const;
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef DB_PREDICATE_H
+#define DB_PREDICATE_H
+
+#include <db/Tuple.h>
+#include <db/TupleBatch.h>
+#include <db/TupleDesc.h>
+#include <db/TuplePage.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace db {
+    /**
+     * A comparison of a field with a constant, such as "field 2 < 100", that
+     * scans evaluate on the page bytes before building any Tuple. A scan with
+     * several predicates keeps the rows that satisfy all of them.
+     * <p>
+     * Filtering a page or a batch reads the field for all the candidate rows
+     * at once and then runs a loop specialized for the type and the operator,
+     * which keeps the matching rows without branching on the comparison.
+     */
+    class Predicate {
+    public:
+        enum class Op {
+            EQUALS, NOT_EQUALS, LESS_THAN, LESS_THAN_OR_EQ, GREATER_THAN, GREATER_THAN_OR_EQ
+        };
+
+    private:
+        int field;
+        Op op;
+        Types::Type type;
+        int32_t intConstant = 0;
+        std::string stringConstant;
+
+    public:
+        /** Compares the INT_TYPE field with index field to constant. */
+        Predicate(int field, Op op, int32_t constant);
+
+        /**
+         * Compares the STRING_TYPE field with index field to constant, by
+         * byte-wise lexicographic order.
+         */
+        Predicate(int field, Op op, std::string constant);
+
+        [[nodiscard]] int getField() const { return field; }
+
+        [[nodiscard]] Op getOp() const { return op; }
+
+        [[nodiscard]] Types::Type getType() const { return type; }
+
+        /**
+         * @throws std::invalid_argument if td has no such field, or it has a
+         *         different type than the constant
+         */
+        void check(const TupleDesc &td) const;
+
+        /** @return true if t satisfies the predicate */
+        [[nodiscard]] bool matches(const Tuple &t) const;
+
+        /**
+         * Removes from slots, used slots of page, those whose row does not
+         * satisfy the predicate, keeping the order of the others.
+         */
+        void filter(const TuplePage &page, std::vector<int> &slots) const;
+
+        /** Removes from the selection of batch the rows that do not satisfy the predicate. */
+        void filter(TupleBatch &batch) const;
+    };
+}
+
+#endif
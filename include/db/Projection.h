@@ -0,0 +1,34 @@
+#ifndef DB_PROJECTION_H
+#define DB_PROJECTION_H
+
+#include <db/TupleDesc.h>
+#include <memory>
+#include <vector>
+
+namespace db {
+    /**
+     * The fields a scan returns, out of the fields of the scanned table. The
+     * projected tuples have only those fields, in the given order, and only
+     * their bytes are read from the pages.
+     */
+    class Projection {
+        std::vector<int> columns;
+        std::shared_ptr<const TupleDesc> td;
+
+    public:
+        /**
+         * @param table the schema of the scanned table
+         * @param columns indices of fields of table, in output order; a field may appear more than once
+         * @throws std::invalid_argument if columns is empty or has an index out of range
+         */
+        Projection(const TupleDesc &table, std::vector<int> columns);
+
+        /** @return the field of the table that field i of a projected tuple comes from */
+        [[nodiscard]] const std::vector<int> &getColumns() const { return columns; }
+
+        /** @return the schema of the projected tuples, owned by this projection */
+        [[nodiscard]] const std::shared_ptr<const TupleDesc> &getTupleDesc() const { return td; }
+    };
+}
+
+#endif
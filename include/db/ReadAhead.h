@@ -0,0 +1,79 @@
+#ifndef DB_READAHEAD_H
+#define DB_READAHEAD_H
+
+#include <db/PageKey.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace db {
+    class BufferPool;
+
+    /**
+     * Sequential read-ahead for the BufferPool. The pool reports misses and
+     * the first hit on each prefetched page; when a file is read in page order,
+     * the next pages are queued and loaded into the pool by background I/O
+     * threads, so the scan finds them already cached instead of waiting on a
+     * synchronous read.
+     */
+    class ReadAhead {
+        /** Access pattern of one file. */
+        struct Stream {
+            int lastPage = -1;   // Page accessed last
+            int runLength = 0;   // Number of consecutive pages accessed in order
+            int prefetchedTo = -1; // Last page already queued for prefetch
+        };
+
+        BufferPool &pool;
+        int numThreads;
+        std::atomic<int> depth;
+
+        std::mutex latch; // Protects everything below
+        std::condition_variable wakeup;
+        std::unordered_map<int, Stream> streams; // Keyed by table id
+        std::deque<PageKey> queue;
+        std::unordered_set<PageKey> queued;
+        std::vector<std::thread> workers; // Started on the first prefetch
+        bool stopping = false;
+
+        void worker();
+
+    public:
+        /** Number of consecutive in-order accesses before a file counts as scanned sequentially. */
+        static constexpr int SEQUENTIAL_THRESHOLD = 2;
+
+        /** Largest number of consecutive queued pages a worker reads in one batch. */
+        static constexpr int MAX_BATCH = 32;
+
+        /**
+         * @param pool the pool pages are loaded into
+         * @param numThreads number of background I/O threads
+         * @param depth number of pages to read ahead of a sequential scan; 0 disables read-ahead
+         */
+        ReadAhead(BufferPool &pool, int numThreads, int depth);
+
+        ReadAhead(const ReadAhead &) = delete;
+
+        /** Drops queued prefetches and joins the I/O threads. */
+        ~ReadAhead();
+
+        [[nodiscard]] int getDepth() const { return depth; }
+
+        void setDepth(int newDepth);
+
+        /**
+         * Reports a miss, or a first hit on a prefetched page, of a HeapFile.
+         * Queues the next pages of the file if it is being read sequentially.
+         * @param key the accessed page
+         * @param numPages the number of pages of the file
+         */
+        void onAccess(const PageKey &key, int numPages);
+    };
+}
+
+#endif
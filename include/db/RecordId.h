@@ -3,19 +3,32 @@
 
 #include <db/HeapPageId.h>
 #include <db/PageId.h>
+#include <cstdint>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
 
 namespace db {
     /**
      * A RecordId is a reference to a specific tuple on a specific page of a
      * specific table.
+     * <p>
+     * It is a plain 16-byte value: the table id, and the page number and tuple
+     * number packed in 64 bits as pageNo << 16 | tupleno. Table ids are 32-bit
+     * hashes of the file name and any non-negative int is a valid page number,
+     * so the three do not fit in one 64-bit word without limiting table sizes.
+     * RecordIds can be copied freely, stored in containers by value and used
+     * as keys of hash tables and ordered indexes, where they sort by table,
+     * page and tuple number.
      */
     class RecordId {
-        const PageId *pid;
-        int tupleno;
+        int tableId = 0;
+        uint64_t location = 0; // pageNo << SLOT_BITS | tupleno
 
     public:
+        /** Number of bits of the tuple number; pages have at most 2^16 slots. */
+        static constexpr int SLOT_BITS = 16;
+
         RecordId() = default;
         /**
          * Creates a new RecordId referring to the specified PageId and tuple
@@ -25,27 +38,55 @@ namespace db {
          *            the pageid of the page on which the tuple resides
          * @param tupleno
          *            the tuple number within the page.
+         * @throws std::out_of_range if the page or tuple number does not fit
          */
         RecordId(const PageId *pid, int tupleno);
 
+        RecordId(const PageId &pid, int tupleno) : RecordId(pid.getTableId(), pid.pageNumber(), tupleno) {}
+
+        RecordId(int tableId, int pageNo, int tupleno);
+
         /**
          * @return the tuple number this RecordId references.
          */
-        int getTupleno() const;
+        int getTupleno() const { return static_cast<int>(location & ((uint64_t{1} << SLOT_BITS) - 1)); }
+
+        /**
+         * @return the table this RecordId references.
+         */
+        int getTableId() const { return tableId; }
+
+        /**
+         * @return the page number this RecordId references.
+         */
+        int getPageNo() const { return static_cast<int>(location >> SLOT_BITS); }
 
         /**
          * @return the page id this RecordId references.
          */
-        const PageId *getPageId() const;
+        HeapPageId getPageId() const { return {tableId, getPageNo()}; }
+
+        /** @return the page and tuple number packed as pageNo << SLOT_BITS | tupleno */
+        uint64_t getLocation() const { return location; }
 
         /**
          * Two RecordId objects are considered equal if they represent the same tuple.
          * @return True if this and o represent the same tuple
          */
-        bool operator==(const RecordId &other) const;
+        bool operator==(const RecordId &other) const {
+            return tableId == other.tableId && location == other.location;
+        }
 
         bool operator!=(const RecordId &other) const { return !(*this == other); }
+
+        /** Orders by table, then page, then tuple number. */
+        bool operator<(const RecordId &other) const {
+            return tableId != other.tableId ? tableId < other.tableId : location < other.location;
+        }
     };
+
+    static_assert(std::is_trivially_copyable_v<RecordId>, "RecordId must be a plain value");
+    static_assert(sizeof(RecordId) == 16, "RecordId is a table id and one 64-bit location");
 }
 
 /**
@@ -0,0 +1,233 @@
+#ifndef DB_REPLACEMENTPOLICY_H
+#define DB_REPLACEMENTPOLICY_H
+
+#include <db/PageKey.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace db {
+    /**
+     * The page replacement algorithms a BufferPool can be constructed with.
+     */
+    enum class ReplacementPolicyType {
+        LRU, CLOCK, TWO_Q, LRU_K
+    };
+
+    /**
+     * ReplacementPolicy decides which frame of the BufferPool is evicted next.
+     * Frames are identified by their index in the pool; the pool reports every
+     * load, hit and removal, and asks the policy for a victim when it is full.
+     * Frames that are pinned are marked non-evictable and never chosen.
+     */
+    class ReplacementPolicy {
+    protected:
+        std::vector<bool> evictable; // Per frame; false while the frame is pinned
+
+    public:
+        explicit ReplacementPolicy(int numFrames) : evictable(numFrames, true) {}
+
+        virtual ~ReplacementPolicy() = default;
+
+        /**
+         * A page has been loaded into a frame.
+         * @param frame index of the frame
+         * @param key the page now held by the frame
+         */
+        virtual void recordInsert(int frame, const PageKey &key) = 0;
+
+        /**
+         * A cached page has been accessed again.
+         * @param frame index of the frame holding the page
+         */
+        virtual void recordAccess(int frame) = 0;
+
+        /**
+         * A frame is emptied without going through selectVictim (e.g. the page
+         * was discarded). The policy stops tracking it.
+         */
+        virtual void remove(int frame) = 0;
+
+        /**
+         * Chooses the next evictable frame to evict and stops tracking it.
+         * @return the victim frame, or -1 if no frame can be evicted
+         */
+        virtual int selectVictim() = 0;
+
+        /**
+         * Marks a frame as (non-)evictable. The pool clears the flag while a
+         * frame is pinned and sets it again when the last pin is released.
+         */
+        virtual void setEvictable(int frame, bool value) { evictable[frame] = value; }
+
+        /**
+         * Creates a policy of the given type for a pool of numFrames frames.
+         */
+        static std::unique_ptr<ReplacementPolicy> create(ReplacementPolicyType type, int numFrames);
+    };
+
+    /**
+     * Intrusive doubly linked list of frame indices. The links are kept in
+     * arrays indexed by frame, so every operation is O(1). A frame may be in at
+     * most one list at a time.
+     */
+    class FrameList {
+        std::vector<int> prev;
+        std::vector<int> next;
+        int head = -1;
+        int tail = -1;
+        size_t count = 0;
+
+    public:
+        explicit FrameList(int numFrames) : prev(numFrames, -1), next(numFrames, -1) {}
+
+        void pushFront(int frame);
+
+        void unlink(int frame);
+
+        void moveToFront(int frame) {
+            if (frame != head) {
+                unlink(frame);
+                pushFront(frame);
+            }
+        }
+
+        /** @return the least recently pushed frame, or -1 if the list is empty */
+        [[nodiscard]] int back() const { return tail; }
+
+        /** @return the frame pushed right after frame (closer to the front), or -1 */
+        [[nodiscard]] int prevOf(int frame) const { return prev[frame]; }
+
+        [[nodiscard]] size_t size() const { return count; }
+    };
+
+    /**
+     * Least recently used. Only evictable frames are linked in the list, so
+     * its back is always the victim; a frame leaves the list while it is
+     * pinned and comes back at the front when it is released.
+     */
+    class LruPolicy : public ReplacementPolicy {
+        FrameList list;
+        std::vector<bool> present; // Per frame; true while the frame holds a tracked page
+
+    public:
+        explicit LruPolicy(int numFrames) : ReplacementPolicy(numFrames), list(numFrames), present(numFrames, false) {}
+
+        void recordInsert(int frame, const PageKey &) override;
+
+        void recordAccess(int frame) override;
+
+        void remove(int frame) override;
+
+        int selectVictim() override;
+
+        void setEvictable(int frame, bool value) override;
+    };
+
+    /**
+     * CLOCK (second chance): a reference bit per frame and a sweeping hand.
+     * Hits only set a bit, so they never touch shared list state.
+     */
+    class ClockPolicy : public ReplacementPolicy {
+        std::vector<bool> present;
+        std::vector<bool> referenced;
+        int hand = 0;
+
+    public:
+        explicit ClockPolicy(int numFrames)
+                : ReplacementPolicy(numFrames), present(numFrames, false), referenced(numFrames, false) {}
+
+        void recordInsert(int frame, const PageKey &key) override;
+
+        void recordAccess(int frame) override { referenced[frame] = true; }
+
+        void remove(int frame) override { present[frame] = false; }
+
+        int selectVictim() override;
+    };
+
+    /**
+     * 2Q (Johnson & Shasha). Pages seen once live in the FIFO A1in; only pages
+     * referenced again after leaving A1in (remembered in the ghost list A1out)
+     * are promoted to the LRU list Am. A large scan therefore cycles through
+     * A1in without flushing the hot pages in Am.
+     * <p>
+     * Only evictable frames are linked in A1in and Am; a pinned frame stays
+     * assigned to its queue and is linked back at the front when released.
+     */
+    class TwoQPolicy : public ReplacementPolicy {
+        enum Queue : uint8_t { NONE, A1IN, AM };
+
+        FrameList a1in;
+        FrameList am;
+        std::vector<Queue> queueOf;
+        size_t a1inSize = 0; // Frames assigned to A1in, pinned or not
+        std::vector<PageKey> keys;
+        std::list<PageKey> a1out; // Ghost entries, most recent at the front
+        std::unordered_map<PageKey, std::list<PageKey>::iterator> a1outIndex;
+        size_t kin;  // Target size of A1in
+        size_t kout; // Maximum number of ghost entries
+
+        /** @return the list of the queue frame is assigned to */
+        FrameList &listOf(int frame) { return queueOf[frame] == AM ? am : a1in; }
+
+        int evictFrom(FrameList &queue);
+
+    public:
+        explicit TwoQPolicy(int numFrames);
+
+        void recordInsert(int frame, const PageKey &key) override;
+
+        void recordAccess(int frame) override;
+
+        void remove(int frame) override;
+
+        int selectVictim() override;
+
+        void setEvictable(int frame, bool value) override;
+    };
+
+    /**
+     * LRU-K (O'Neil et al.): evicts the frame whose K-th most recent access is
+     * the oldest. Frames with fewer than K accesses are evicted first, oldest
+     * first, so pages touched once by a scan go before re-referenced ones.
+     */
+    class LruKPolicy : public ReplacementPolicy {
+        /**
+         * (has K accesses, oldest access in the window, frame), smallest is the
+         * victim. Only frames that are present and evictable are in the set.
+         */
+        using Entry = std::tuple<bool, uint64_t, int>;
+
+        int k;
+        uint64_t now = 0;
+        std::vector<std::vector<uint64_t>> history; // Up to k most recent accesses per frame, oldest first
+        std::vector<bool> present;
+        std::set<Entry> order;
+
+        [[nodiscard]] Entry entryOf(int frame) const;
+
+        void touch(int frame);
+
+    public:
+        static constexpr int DEFAULT_K = 2;
+
+        explicit LruKPolicy(int numFrames, int k = DEFAULT_K);
+
+        void recordInsert(int frame, const PageKey &key) override;
+
+        void recordAccess(int frame) override;
+
+        void remove(int frame) override;
+
+        int selectVictim() override;
+
+        void setEvictable(int frame, bool value) override;
+    };
+}
+
+#endif
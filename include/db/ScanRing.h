@@ -0,0 +1,71 @@
+#ifndef DB_SCANRING_H
+#define DB_SCANRING_H
+
+#include <db/FrameArena.h>
+#include <db/Page.h>
+#include <db/PageId.h>
+#include <db/PageKey.h>
+#include <vector>
+
+namespace db {
+    /**
+     * A small private set of frames that a large sequential scan reads through
+     * instead of the shared frames of the BufferPool. Frames are reused in
+     * round-robin order, so a scan of a table much larger than the pool only
+     * ever occupies the ring and leaves the cached working set alone.
+     * <p>
+     * A ring belongs to one scan and is not thread-safe. Pages read through it
+     * are private read-only copies; it must not outlive a change of the pool
+     * page size.
+     */
+    class ScanRing {
+        struct Slot {
+            PageKey key{-1, -1};
+            Page *page = nullptr;
+            int pinCount = 0;
+        };
+
+        FrameArena arena;
+        std::vector<Slot> slots;
+        size_t next = 0; // Slot reused by the next load
+
+        /** @return the slot holding key, or -1 */
+        int find(const PageKey &key) const;
+
+    public:
+        /** Default number of frames in a ring. */
+        static constexpr int DEFAULT_SIZE = 16;
+
+        /**
+         * @param numSlots number of frames in the ring; at least 2 so that a
+         *        scan can pin the next page before releasing the current one
+         * @param pageSize bytes per frame
+         */
+        ScanRing(int numSlots, size_t pageSize);
+
+        ScanRing(const ScanRing &) = delete;
+
+        ScanRing &operator=(const ScanRing &) = delete;
+
+        /** Every PageGuard of the ring must have been released. */
+        ~ScanRing();
+
+        /**
+         * Pins the page in the ring, reading it into the oldest unpinned frame
+         * unless the ring holds it already. On a miss in a HeapFile, the pages
+         * following it are read into the next unpinned frames in the same
+         * batch, up to window pages in all and at most half the ring, so a
+         * scan issues one batched read per window instead of one per page.
+         * @param window number of pages to read on a miss, at least 1
+         * @param slot set to the frame holding the page
+         * @param prefetched set to the number of pages read after pid
+         * @throws std::runtime_error if every frame of the ring is pinned
+         */
+        Page *pin(const PageId &pid, int window, int &slot, int &prefetched);
+
+        /** Releases one pin of a frame. */
+        void unpin(int slot);
+    };
+}
+
+#endif
@@ -9,15 +9,17 @@
 #include <db/TransactionId.h>
 #include <db/TupleDesc.h>
 #include <db/DbFile.h>
+#include <db/HeapFile.h>
+#include <db/Predicate.h>
+#include <db/Projection.h>
+#include <optional>
 
 namespace db {
     class SeqScan;
     class SeqScanIterator {
         // TODO pa1.6: Add private members as needed
     const SeqScan *scan;            // Pointer to the SeqScan operator
-    bool isBegin;             // Indicates if the iterator is at the beginning of the scan
-    int currentPageIndex;     // Current page index
-    int currentTupleIndex;    // Current tuple index within the page
+    HeapFileIterator fileIter; // Position in the scanned file; pins the current page
 
     public:
         SeqScanIterator(const SeqScan *scan, bool isBegin);
@@ -25,6 +27,14 @@ namespace db {
         SeqScanIterator &operator++();
         const Tuple &operator*() const;
 
+        /**
+         * Replaces the contents of batch with the next rows of the scan and
+         * moves past them. Create the batch with the schema of the table,
+         * Catalog::getSharedTupleDesc(scan.getTableId()).
+         * @return the number of rows read, 0 when the scan is done
+         */
+        size_t nextBatch(TupleBatch &batch);
+
     };
 
     /**
@@ -40,6 +50,8 @@ namespace db {
         int tableid;                   // The ID of the table to scan
         std::string tableAlias;        // The alias of the table
         TupleDesc tupleDesc;           // Tuple descriptor for the table being scanned
+        std::vector<Predicate> predicates; // Conjunction the returned tuples satisfy
+        std::optional<Projection> projection; // Fields of the returned tuples, if not all
 
     public:
 
@@ -84,12 +96,39 @@ namespace db {
          *            tableAlias or fieldName are null. It shouldn't crash if they
          *            are, but the resulting name can be null.fieldName,
          *            tableAlias.null, or null.null).
+         * Predicates and a projection given to the constructor are dropped.
          */
         void reset(int tableid, const std::string &tableAlias);
 
         SeqScan(TransactionId *tid, int tableid) :
                 SeqScan(tid, tableid, Database::getCatalog().getTableName(tableid)) {}
 
+        /**
+         * Creates a sequential scan that only returns the tuples satisfying
+         * all of predicates. They are evaluated on the page bytes, so no Tuple
+         * is built for the other rows.
+         * @throws std::invalid_argument if a predicate does not fit the table's schema
+         */
+        SeqScan(TransactionId *tid, int tableid, const std::string &tableAlias, std::vector<Predicate> predicates);
+
+        /**
+         * Creates a sequential scan that returns the given fields of the
+         * tuples satisfying all of predicates. Only the bytes of those fields
+         * are read, and getTupleDesc() describes the projected tuples. A
+         * returned tuple stays valid until the iterator moves.
+         * @param predicates conditions on the fields of the table, not of the projection
+         * @param columns indices of fields of the table, in output order
+         * @throws std::invalid_argument if a predicate or a column does not fit the table's schema
+         */
+        SeqScan(TransactionId *tid, int tableid, const std::string &tableAlias, std::vector<Predicate> predicates,
+                std::vector<int> columns);
+
+        /** @return the predicates the returned tuples satisfy */
+        const std::vector<Predicate> &getPredicates() const;
+
+        /** @return the fields the scan returns, or null if it returns all of them */
+        const Projection *getProjection() const;
+
         /**
          * Returns the TupleDesc with field names from the underlying HeapFile,
          * prefixed with the tableAlias string from the constructor. This prefix
@@ -34,6 +34,8 @@ namespace db {
 
         Page *readPage(const PageId &pid);
 
+        void writePage(Page *page) const override;
+
         iterator begin() const;
 
         iterator end() const;
@@ -0,0 +1,124 @@
+#ifndef DB_SLOTTEDPAGE_H
+#define DB_SLOTTEDPAGE_H
+
+#include <db/HeapPageId.h>
+#include <db/TuplePage.h>
+#include <db/TupleDesc.h>
+#include <optional>
+
+namespace db {
+    /**
+     * A page of variable-length records, for tables whose strings are mostly
+     * much shorter than Types::STRING_LEN. A HeapFile stores its pages in this
+     * format when it is created with PageFormat::SLOTTED.
+     * <p>
+     * Layout of the page bytes:
+     * <pre>
+     *   numSlots (2 bytes) | dataStart (2 bytes) | slot directory | free space | records
+     * </pre>
+     * The slot directory has one entry per slot: the offset and the length of
+     * its record, 2 bytes each; offset 0 marks an empty slot. Records are
+     * packed at the end of the page and grow towards the directory; dataStart
+     * is the offset of the lowest one, 0 meaning the end of the page, so a
+     * zero-filled page is an empty page. A record holds the fields in
+     * TupleDesc order: an INT_TYPE as 4 bytes, a STRING_TYPE as a 2-byte
+     * length followed by the characters.
+     * <p>
+     * Deleting a record leaves a hole; insertTuple compacts the page when the
+     * contiguous free space is too small but the holes are large enough.
+     * Tuples returned by getTuple are read-only copies: change a record by
+     * deleting and inserting it.
+     */
+    class SlottedPage : public TuplePage {
+        HeapPageId pid;
+        std::shared_ptr<const TupleDesc> td; // Interned by the Catalog
+        uint8_t *data;   // Page bytes
+        bool ownsData;   // False when data points into a BufferPool frame
+        size_t pageSize;
+        std::optional<TransactionId> dirtier; // Set while the page is dirty
+
+        static constexpr size_t HEADER_SIZE = 4;
+        static constexpr size_t SLOT_SIZE = 4;
+
+        [[nodiscard]] uint16_t read16(size_t offset) const;
+
+        void write16(size_t offset, uint16_t value);
+
+        [[nodiscard]] size_t dataStart() const;
+
+        [[nodiscard]] size_t recordOffset(int slot) const { return read16(HEADER_SIZE + slot * SLOT_SIZE); }
+
+        [[nodiscard]] size_t recordLength(int slot) const { return read16(HEADER_SIZE + slot * SLOT_SIZE + 2); }
+
+        /** @return the bytes of field col of the record in slot, checking both and the type */
+        [[nodiscard]] const uint8_t *fieldData(int slot, int col, Types::Type type) const;
+
+        /** @return the number of bytes t takes as a record, checking it against the TupleDesc */
+        [[nodiscard]] size_t recordSize(const Tuple &t) const;
+
+        Tuple *readTuple(int slot) const override;
+
+    public:
+        /**
+         * @param inPlace keep reading from data instead of copying it, so data
+         *        must outlive the page
+         * @throws std::runtime_error if the slot directory does not fit in the page
+         */
+        SlottedPage(const HeapPageId &id, uint8_t *data, bool inPlace);
+
+        ~SlottedPage() override;
+
+        PageId &getId() override;
+
+        /**
+         * @return a copy of the page bytes; records changed through tuples
+         *         returned by getTuple are not written back
+         */
+        void *getPageData() override;
+
+        void markDirty(bool dirty, const TransactionId &tid) override;
+
+        [[nodiscard]] const TransactionId *isDirty() const override;
+
+        /** @return the number of entries of the slot directory */
+        [[nodiscard]] int getNumSlots() const override;
+
+        /** @return the number of entries of the slot directory that are empty */
+        [[nodiscard]] int getNumEmptySlots() const override;
+
+        [[nodiscard]] bool isSlotUsed(int i) const override;
+
+        [[nodiscard]] int nextUsedSlot(int from) const override;
+
+        size_t getUsedSlots(std::vector<int> &slots) const override;
+
+        [[nodiscard]] int getInt(int slot, int col) const override;
+
+        [[nodiscard]] std::string_view getStringView(int slot, int col) const override;
+
+        /**
+         * @return the number of bytes available for new records and their
+         *         directory entries, counting the holes left by deletes
+         */
+        [[nodiscard]] size_t getFreeSpace() const;
+
+        /**
+         * Stores t in an empty slot, or in a new one at the end of the
+         * directory, compacting the page first if needed.
+         * @return the slot of the record, or -1 if it does not fit
+         * @throws std::invalid_argument if t does not match the TupleDesc of the page
+         */
+        int insertTuple(const Tuple &t);
+
+        /**
+         * Empties a slot. Trailing empty slots are removed from the directory.
+         * @throws std::out_of_range if the slot is not used
+         */
+        void deleteTuple(int slot);
+
+        /** Moves the records together at the end of the page, so that the free space is contiguous. */
+        void compact();
+    };
+}
+
+#endif
@@ -4,33 +4,98 @@
 #include <db/TupleDesc.h>
 #include <db/Field.h>
 #include <db/RecordId.h>
+#include <db/Value.h>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
 
 namespace db {
+    class TupleFieldIterator;
+
     /**
      * Tuple maintains information about the contents of a tuple.
      * Tuples have a specified schema specified by a TupleDesc object
      * and contain Field objects with the data for each field.
+     * <p>
+     * The values are stored inline, one Value per field, with the characters
+     * of all STRING_TYPE values in a single buffer. getInt and getString read
+     * them directly; getField builds a Field for a value on first use, for
+     * code written against the Field interface.
+     * <p>
+     * The values, the characters and the Fields come from the memory resource
+     * given to the constructor, e.g. the TupleArena of the page the tuple was
+     * decoded from. A copy of a tuple always uses the default resource; a
+     * moved-to tuple keeps the resource of the tuple it was moved from.
      */
     class Tuple {
-        std::vector<const Field*> fields;   // Collection of Field pointers.
-        TupleDesc tupleDesc;   // Reference to schema (non-owning pointer).
-        const RecordId* recordId{};     // Reference to the record ID (non-owning pointer).
-        using iterator = std::vector<const Field*>::const_iterator;
+        std::pmr::vector<Value> values;   // One per field, in TupleDesc order
+        std::pmr::string strings;         // Characters of the STRING_TYPE values
+        std::shared_ptr<const TupleDesc> tupleDesc;   // Schema, shared with the other tuples of the table
+        std::optional<RecordId> recordId;     // Location of the tuple on disk, if it has one
+        // Field of each value, built by getField on first use. Tuples are
+        // shared between threads by pages, so the array and its entries are
+        // published with a compare-and-swap.
+        mutable std::atomic<std::atomic<const Field *> *> fields{nullptr};
+        using iterator = TupleFieldIterator;
+
+        /** @throws std::out_of_range if i is not a valid field index */
+        void checkIndex(int i) const;
+
+        /** Drops the Field built for value i, after the value changed. */
+        void forgetField(int i);
+
+        /** Drops all the Fields built by getField, and the array holding them. */
+        void dropFields();
 
     public:
         Tuple() = default;
 
+        Tuple(const Tuple &other);
+
+        Tuple &operator=(const Tuple &other);
+
+        /** Takes the values, characters and built Fields of other, leaving it empty. */
+        Tuple(Tuple &&other) noexcept;
+
+        /**
+         * Takes the storage of other, leaving it empty. If the tuples use
+         * different memory resources, the values and characters are copied
+         * into the resource of this tuple instead, which may allocate.
+         * @throws std::bad_alloc if the copy fails; both tuples are unchanged
+         */
+        Tuple &operator=(Tuple &&other);
+
+        ~Tuple();
+
         /**
          * Create a new tuple with the specified schema (type).
          * @param td the schema of this tuple. It must be a valid TupleDesc instance with at least one field.
          */
-        explicit Tuple(const TupleDesc &td, RecordId *rid = nullptr);
+        explicit Tuple(const TupleDesc &td, const RecordId *rid = nullptr);
+
+        /**
+         * Create a new tuple referencing a shared schema, e.g. one interned by
+         * the Catalog, instead of copying it.
+         */
+        explicit Tuple(std::shared_ptr<const TupleDesc> td, const RecordId *rid = nullptr);
+
+        /**
+         * @param memory where the values and Fields of the tuple are
+         *        allocated; it must outlive the tuple
+         */
+        Tuple(std::shared_ptr<const TupleDesc> td, const RecordId &rid,
+              std::pmr::memory_resource *memory = std::pmr::get_default_resource());
 
         /**
          * @return The TupleDesc representing the schema of this tuple.
          */
         [[nodiscard]] const TupleDesc &getTupleDesc() const;
 
+        /** @return the shared schema of this tuple, null for a default-constructed tuple */
+        [[nodiscard]] const std::shared_ptr<const TupleDesc> &getSharedTupleDesc() const { return tupleDesc; }
+
         /**
          * @return The RecordId representing the location of this tuple on disk. May be null.
          */
@@ -38,23 +103,57 @@ namespace db {
 
         /**
          * Set the RecordId information for this tuple.
-         * @param rid the new RecordId for this tuple.
+         * @param rid the new RecordId for this tuple, copied; null clears it.
          */
         void setRecordId(const RecordId *id);
 
         /**
-         * @return the value of the ith field, or null if it has not been set.
+         * @return the value of the ith field; a field that has not been set is 0 or the empty string.
          * @param i field index to return. Must be a valid index.
+         * The Field stays valid until the field is changed or the tuple is destroyed.
          */
         [[nodiscard]] const Field &getField(int i) const;
 
         /**
          * Change the value of the ith field of this tuple.
          * @param i index of the field to change. It must be a valid index.
-         * @param f new value for the field.
+         * @param f new value for the field. Its value is copied; the caller keeps ownership of f.
          */
         void setField(int i, const Field *f);
 
+        /** @return the inline value of the ith field */
+        [[nodiscard]] const Value &getValue(int i) const;
+
+        /**
+         * @return the ith field, which must be an INT_TYPE
+         * @throws std::invalid_argument if it is not
+         */
+        [[nodiscard]] int getInt(int i) const;
+
+        /**
+         * @return the characters of the ith field, which must be a STRING_TYPE;
+         *         the view is valid until the field is changed
+         * @throws std::invalid_argument if it is not
+         */
+        [[nodiscard]] std::string_view getString(int i) const;
+
+        void setInt(int i, int value);
+
+        /** Sets the ith field to a string, truncated to Types::STRING_LEN - 1 characters. */
+        void setString(int i, std::string_view value);
+
+        /**
+         * Sets every field back to 0 or the empty string. The memory of the
+         * values is kept, so refilling the tuple does not allocate.
+         */
+        void clear();
+
+        /**
+         * Writes the ith field in its page format, Types::getLen bytes, as
+         * Field::serialize does.
+         */
+        void serializeField(int i, void *data) const;
+
         /**
          *   An iterator which iterates over all the fields of a tuple
          */
@@ -69,6 +168,23 @@ namespace db {
         [[nodiscard]] std::string to_string() const;
     };
 
+    /** Iterates over the fields of a tuple as Field pointers. */
+    class TupleFieldIterator {
+        const Tuple *tuple;
+        int i;
+    public:
+        TupleFieldIterator(const Tuple *tuple, int i) : tuple(tuple), i(i) {}
+
+        bool operator!=(const TupleFieldIterator &other) const { return i != other.i || tuple != other.tuple; }
+
+        TupleFieldIterator &operator++() {
+            i++;
+            return *this;
+        }
+
+        const Field *operator*() const { return &tuple->getField(i); }
+    };
+
 }
 
 #endif
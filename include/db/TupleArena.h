@@ -0,0 +1,44 @@
+#ifndef DB_TUPLEARENA_H
+#define DB_TUPLEARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace db {
+    /**
+     * A bump allocator for the tuples decoded from a page, or built while
+     * running a query. Allocating is a pointer increment into blocks of
+     * growing size; deallocating does nothing, and all the memory is released
+     * at once when the arena is destroyed, e.g. when the page is evicted.
+     * <p>
+     * Unlike std::pmr::monotonic_buffer_resource, it can be shared between
+     * threads: pages are, and several threads may decode tuples of the same
+     * page at the same time.
+     */
+    class TupleArena : public std::pmr::memory_resource {
+        std::mutex latch;
+        std::pmr::monotonic_buffer_resource arena;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void *, size_t, size_t) override {}
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        /** Bytes of the first block; later blocks grow geometrically. */
+        static constexpr size_t INITIAL_SIZE = 4096;
+
+        explicit TupleArena(size_t initialSize = INITIAL_SIZE) : arena(initialSize) {}
+
+        TupleArena(const TupleArena &) = delete;
+
+        TupleArena &operator=(const TupleArena &) = delete;
+    };
+}
+
+#endif
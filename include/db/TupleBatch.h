@@ -0,0 +1,110 @@
+#ifndef DB_TUPLEBATCH_H
+#define DB_TUPLEBATCH_H
+
+#include <db/BufferPool.h>
+#include <db/RecordId.h>
+#include <db/ScanRing.h>
+#include <db/TupleDesc.h>
+#include <db/TuplePage.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace db {
+    /**
+     * A batch of up to getCapacity() rows of a table, stored column by column:
+     * each INT_TYPE field as a contiguous array of ints and each STRING_TYPE
+     * field as an array of views into the page bytes. Scans fill a batch
+     * directly from the pages with nextBatch, without building Tuples.
+     * <p>
+     * The selection vector holds the indices of the rows that are still
+     * selected, in increasing order; filling a batch selects every row, and
+     * filters shrink it instead of moving the column values.
+     * <p>
+     * The batch keeps the pages its rows came from pinned, and the ScanRing
+     * they were read through alive, so the string views stay valid until the
+     * batch is cleared, refilled or destroyed, even after the scan is gone.
+     */
+    class TupleBatch {
+        std::shared_ptr<const TupleDesc> td;
+        size_t capacity;
+        size_t numRows = 0;
+        std::vector<std::vector<int32_t>> intColumns;             // By field; empty for STRING_TYPE fields
+        std::vector<std::vector<std::string_view>> stringColumns; // By field; empty for INT_TYPE fields
+        std::vector<RecordId> recordIds;
+        std::vector<uint32_t> selection;
+        // Rings the pinned pages may belong to; declared before pins so that
+        // the pins are released first
+        std::vector<std::shared_ptr<ScanRing>> rings;
+        std::vector<PageGuard> pins; // Pages the rows were read from
+
+    public:
+        /** Default number of rows in a batch. */
+        static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+        /**
+         * Most pages a batch holds pinned. It stays well below the size of a
+         * ScanRing, which must also fit the page the scan is on.
+         */
+        static constexpr size_t MAX_PAGES = ScanRing::DEFAULT_SIZE / 2;
+
+        /**
+         * @param td the schema of the rows, e.g. from Catalog::getSharedTupleDesc
+         * @throws std::invalid_argument if capacity is 0
+         */
+        explicit TupleBatch(std::shared_ptr<const TupleDesc> td, size_t capacity = DEFAULT_CAPACITY);
+
+        [[nodiscard]] const TupleDesc &getTupleDesc() const { return *td; }
+
+        [[nodiscard]] size_t getCapacity() const { return capacity; }
+
+        /** @return the number of rows, selected or not */
+        [[nodiscard]] size_t size() const { return numRows; }
+
+        [[nodiscard]] bool isFull() const { return numRows == capacity; }
+
+        /** @return the number of pages the batch holds pinned */
+        [[nodiscard]] size_t getNumPages() const { return pins.size(); }
+
+        /**
+         * @return the values of field col, size() of them
+         * @throws std::invalid_argument if field col is not an INT_TYPE
+         */
+        [[nodiscard]] const int32_t *getIntColumn(int col) const;
+
+        /**
+         * @return the values of field col, size() of them, pointing into the
+         *         pinned pages
+         * @throws std::invalid_argument if field col is not a STRING_TYPE
+         */
+        [[nodiscard]] const std::string_view *getStringColumn(int col) const;
+
+        /** @return where row was read from */
+        [[nodiscard]] const RecordId &getRecordId(size_t row) const { return recordIds[row]; }
+
+        /** @return the indices of the selected rows, in increasing order */
+        [[nodiscard]] const std::vector<uint32_t> &getSelection() const { return selection; }
+
+        /** @return the selection vector, for filters to shrink */
+        std::vector<uint32_t> &getSelection() { return selection; }
+
+        /** Removes all rows and unpins their pages. */
+        void clear();
+
+        /**
+         * Appends and selects the rows in slots of a page, reading each field
+         * for all of them at once. The batch keeps the pin on the page.
+         * @param pin a pin on a TuplePage
+         * @param slots used slots of the page, at most getCapacity() - size()
+         * @param columns the field of the page each field of the batch is
+         *        read from, or null if they are the same
+         * @param ring the ScanRing holding the page, if any; the batch keeps it
+         *        alive while it holds the pin
+         */
+        void append(PageGuard pin, const std::vector<int> &slots, const std::vector<int> *columns = nullptr,
+                    const std::shared_ptr<ScanRing> &ring = nullptr);
+    };
+}
+
+#endif
@@ -35,14 +35,28 @@ namespace db {
 
     /**
      * TupleDesc describes the schema of a tuple.
+     * <p>
+     * The byte layout of a tuple, the offset of each field and the total size,
+     * is computed once when the TupleDesc is built.
      */
     class TupleDesc {
         using iterator = std::vector<TDItem>::const_iterator;
 
     private:
         std::vector<TDItem> fieldDescriptions; // Container to store field descriptions
+        std::vector<size_t> fieldOffsets;      // Byte offset of each field in a serialized tuple
+        size_t size = 0;                       // Bytes of a serialized tuple
+
+        /** Computes fieldOffsets and size from fieldDescriptions. */
+        void computeLayout();
 
     public:
+        /** How tuples of this TupleDesc fill a fixed-slot page of a given size. */
+        struct PageLayout {
+            int numSlots;   // floor((pageSize * 8) / (tuple size * 8 + 1))
+            int headerSize; // Bytes of the slot bitmap: ceiling(numSlots / 8)
+        };
+
         TupleDesc() = default;
 
         /**
@@ -104,7 +118,22 @@ namespace db {
          * @return The size (in bytes) of tuples corresponding to this TupleDesc.
          *         Note that tuples from a given TupleDesc are of a fixed size.
          */
-        [[nodiscard]] size_t getSize() const;
+        [[nodiscard]] size_t getSize() const { return size; }
+
+        /**
+         * @return the byte offset of the ith field in a serialized tuple
+         * @throws std::out_of_range if i is not a valid index
+         */
+        [[nodiscard]] size_t getFieldOffset(size_t i) const;
+
+        /**
+         * @return the number of slots and header bytes of a page of pageSize
+         *         bytes holding tuples of this TupleDesc, as laid out by HeapPage
+         */
+        [[nodiscard]] PageLayout getPageLayout(size_t pageSize) const {
+            int numSlots = size == 0 ? 0 : static_cast<int>((pageSize * 8) / (size * 8 + 1));
+            return {numSlots, (numSlots + 7) / 8};
+        }
 
         /**
          * Merge two TupleDescs into one, with td1.numFields + td2.numFields fields,
@@ -0,0 +1,149 @@
+#ifndef DB_TUPLEPAGE_H
+#define DB_TUPLEPAGE_H
+
+#include <db/Page.h>
+#include <db/Tuple.h>
+#include <db/TupleArena.h>
+#include <atomic>
+#include <string_view>
+#include <vector>
+
+namespace db {
+    class TuplePageIterator;
+
+    /**
+     * A Page that stores the tuples of a table in numbered slots. Scans work
+     * through this interface, whatever the layout of the page bytes is.
+     * <p>
+     * Values can be read straight from the page bytes with getInt and
+     * getStringView. A Tuple is only built the first time its slot is
+     * requested, and is then kept by the page.
+     * <p>
+     * Decoded tuples, their values and their Fields are bump-allocated in an
+     * arena of the page, and all released at once with the page, when it is
+     * evicted from the BufferPool or leaves a ScanRing.
+     */
+    class TuplePage : public Page {
+        int tupleCapacity;
+        mutable TupleArena arena; // Memory of the decoded tuples
+        // Tuple of each slot, built on first access; the array itself is only
+        // allocated then too. Pages are shared between threads, so both are
+        // published with a compare-and-swap.
+        mutable std::atomic<std::atomic<Tuple *> *> tuples{nullptr};
+
+    protected:
+        /**
+         * @param tupleCapacity the largest number of slots the page can have
+         */
+        explicit TuplePage(int tupleCapacity) : tupleCapacity(tupleCapacity) {}
+
+        /** Builds the tuple of a used slot from the page bytes, with newTuple. */
+        virtual Tuple *readTuple(int slot) const = 0;
+
+        /** @return a tuple allocated in the arena of the page, to be returned by readTuple */
+        Tuple *newTuple(const std::shared_ptr<const TupleDesc> &td, const RecordId &rid) const;
+
+        /** @return the tuple of slot if it was decoded already, or nullptr */
+        [[nodiscard]] const Tuple *decodedTuple(int slot) const;
+
+        /** Drops the decoded tuple of slot, e.g. when the slot is deleted. */
+        void forgetTuple(int slot);
+
+    public:
+        TuplePage(const TuplePage &) = delete;
+
+        TuplePage &operator=(const TuplePage &) = delete;
+
+        ~TuplePage() override;
+
+        /** @return the number of slots, used or not */
+        [[nodiscard]] virtual int getNumSlots() const = 0;
+
+        /**
+         * Returns true if associated slot on this page is filled.
+         */
+        [[nodiscard]] virtual bool isSlotUsed(int i) const = 0;
+
+        /**
+         * @return the first used slot at or after slot from, or the number of
+         *         slots if there is none
+         */
+        [[nodiscard]] virtual int nextUsedSlot(int from) const = 0;
+
+        /**
+         * Replaces the contents of slots with the indices of the used slots, in
+         * order. Reusing the same vector across pages avoids allocating.
+         * @return the number of used slots
+         */
+        virtual size_t getUsedSlots(std::vector<int> &slots) const = 0;
+
+        /**
+         * Returns the number of empty slots on this page.
+         */
+        [[nodiscard]] virtual int getNumEmptySlots() const = 0;
+
+        /**
+         * Reads an INT_TYPE field of a used slot straight from the page bytes,
+         * without building the Tuple.
+         * @throws std::out_of_range if slot or col is out of range
+         * @throws std::invalid_argument if field col is not an INT_TYPE
+         */
+        [[nodiscard]] virtual int getInt(int slot, int col) const = 0;
+
+        /**
+         * Reads a STRING_TYPE field of a used slot straight from the page
+         * bytes. The view points into the page and is valid while the page is.
+         * @throws std::out_of_range if slot or col is out of range
+         * @throws std::invalid_argument if field col is not a STRING_TYPE
+         */
+        [[nodiscard]] virtual std::string_view getStringView(int slot, int col) const = 0;
+
+        /**
+         * Reads INT_TYPE field col of count used slots into out, as getInt
+         * would. Pages override it to read the whole column in one loop.
+         * @throws std::invalid_argument if field col is not an INT_TYPE
+         */
+        virtual void readIntColumn(int col, const int *slots, size_t count, int32_t *out) const;
+
+        /**
+         * Reads STRING_TYPE field col of count used slots into out, as
+         * getStringView would.
+         * @throws std::invalid_argument if field col is not a STRING_TYPE
+         */
+        virtual void readStringColumn(int col, const int *slots, size_t count, std::string_view *out) const;
+
+        /**
+         * @return the tuple of a used slot, decoding it on first access
+         * @throws std::out_of_range if slot is out of range or not used
+         */
+        Tuple &getTuple(int slot) const;
+
+        // Begin and End methods for iterators
+        [[nodiscard]] TuplePageIterator begin() const;
+
+        [[nodiscard]] TuplePageIterator end() const;
+    };
+
+    /**
+     * @return an iterator over all tuples on this page
+     * (note that this iterator shouldn't return tuples in empty slots!)
+     */
+    class TuplePageIterator {
+        int slot;
+        const TuplePage *page;
+    public:
+        TuplePageIterator(int slot, const TuplePage *page);
+
+        bool operator!=(const TuplePageIterator &other) const;
+
+        /** Decodes the tuple of the current slot if that was not done yet. */
+        Tuple &operator*() const;
+
+        TuplePageIterator &operator++();
+
+        /** @return the slot the iterator is at, for getInt and getStringView */
+        [[nodiscard]] int getSlot() const { return slot; }
+    };
+}
+
+#endif
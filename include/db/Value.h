@@ -0,0 +1,57 @@
+#ifndef DB_VALUE_H
+#define DB_VALUE_H
+
+#include <db/Type.h>
+#include <cstdint>
+
+namespace db {
+    /**
+     * The value of one field of a Tuple, stored inline instead of as a heap
+     * allocated Field. An INT_TYPE value holds the int itself; a STRING_TYPE
+     * value holds the offset and length of its characters in a buffer owned
+     * by whoever stores the Value, e.g. the string buffer of a Tuple.
+     */
+    class Value {
+        Types::Type type;
+        union {
+            int32_t intValue;
+            struct {
+                uint32_t offset;
+                uint32_t length;
+            } string;
+        };
+
+    public:
+        Value() : type(Types::INT_TYPE), string{0, 0} {}
+
+        static Value ofInt(int32_t value) {
+            Value v;
+            v.intValue = value;
+            return v;
+        }
+
+        /**
+         * @param offset where the characters start in the owner's buffer
+         * @param length the number of characters
+         */
+        static Value ofString(uint32_t offset, uint32_t length) {
+            Value v;
+            v.type = Types::STRING_TYPE;
+            v.string = {offset, length};
+            return v;
+        }
+
+        [[nodiscard]] Types::Type getType() const { return type; }
+
+        /** @return the int of an INT_TYPE value */
+        [[nodiscard]] int32_t getInt() const { return intValue; }
+
+        /** @return the offset of the characters of a STRING_TYPE value */
+        [[nodiscard]] uint32_t getStringOffset() const { return string.offset; }
+
+        /** @return the number of characters of a STRING_TYPE value */
+        [[nodiscard]] uint32_t getStringLength() const { return string.length; }
+    };
+}
+
+#endif